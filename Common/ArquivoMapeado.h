@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Arquivo mapeado em memória, somente leitura (mmap no POSIX, MapViewOfFile no
+// Windows). As páginas só são lidas do disco quando acessadas, e os dados podem ir
+// direto do mapeamento para um buffer da GPU, sem cópia intermediária.
+class ArquivoMapeado {
+public:
+	ArquivoMapeado() = default;
+	ArquivoMapeado(const ArquivoMapeado &) = delete;
+	ArquivoMapeado &operator=(const ArquivoMapeado &) = delete;
+	~ArquivoMapeado() { fechar(); }
+
+	bool abrir(const std::string &arquivo)
+	{
+		fechar();
+#ifdef _WIN32
+		hArquivo = CreateFileA(arquivo.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (hArquivo == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER t;
+		if (!GetFileSizeEx(hArquivo, &t) || t.QuadPart == 0)
+		{
+			fechar();
+			return false;
+		}
+		tam = (size_t)t.QuadPart;
+		hMapeamento = CreateFileMappingA(hArquivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!hMapeamento)
+		{
+			fechar();
+			return false;
+		}
+		ptr = MapViewOfFile(hMapeamento, FILE_MAP_READ, 0, 0, 0);
+#else
+		fd = open(arquivo.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0)
+		{
+			fechar();
+			return false;
+		}
+		tam = (size_t)st.st_size;
+		void *p = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+		ptr = p == MAP_FAILED ? nullptr : p;
+		if (ptr)
+			madvise(ptr, tam, MADV_SEQUENTIAL);
+#endif
+		if (!ptr)
+		{
+			fechar();
+			return false;
+		}
+		return true;
+	}
+
+	void fechar()
+	{
+#ifdef _WIN32
+		if (ptr)
+			UnmapViewOfFile(ptr);
+		if (hMapeamento)
+			CloseHandle(hMapeamento);
+		if (hArquivo != INVALID_HANDLE_VALUE)
+			CloseHandle(hArquivo);
+		hMapeamento = nullptr;
+		hArquivo = INVALID_HANDLE_VALUE;
+#else
+		if (ptr)
+			munmap(ptr, tam);
+		if (fd >= 0)
+			close(fd);
+		fd = -1;
+#endif
+		ptr = nullptr;
+		tam = 0;
+	}
+
+	const char *dados() const { return (const char *)ptr; }
+	size_t tamanho() const { return tam; }
+
+private:
+	void *ptr = nullptr;
+	size_t tam = 0;
+#ifdef _WIN32
+	HANDLE hArquivo = INVALID_HANDLE_VALUE;
+	HANDLE hMapeamento = nullptr;
+#else
+	int fd = -1;
+#endif
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ArquivoMapeado.h>
+#include <PoolVertices.h>
+
+// Cena de formas desenhadas pelo usuário (M2), salva como o conteúdo do PoolVertices:
+// nFormas formas de verticesPorForma vértices cada, com posição e cor por vértice.
+// As transformações já estão aplicadas às posições, como no buffer da GPU.
+//
+// Binário (.pgsc): "PGSC" | versao u32 | nFormas u32 | verticesPorForma u32 |
+//                  nFormas * verticesPorForma VerticeCor (6 floats)
+// O bloco de vértices tem exatamente o layout do VBO: o arquivo é mapeado em
+// memória e enviado direto para a GPU, sem parsing nem cópia.
+//
+// Texto (qualquer outra extensão, para inspecionar ou editar à mão):
+//   PGSC-TEXTO 1
+//   <nFormas> <verticesPorForma>
+//   x y z r g b        (uma linha por vértice)
+
+#pragma pack(push, 1)
+struct CabecalhoCena {
+	char magic[4];
+	uint32_t versao;
+	uint32_t nFormas;
+	uint32_t verticesPorForma;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CabecalhoCena) == 16, "cabecalho da cena deve ter 16 bytes");
+static_assert(sizeof(VerticeCor) == 24, "VerticeCor deve ter 6 floats sem padding");
+
+inline bool cenaEhBinaria(const std::string &arquivo)
+{
+	return arquivo.size() >= 5 && arquivo.compare(arquivo.size() - 5, 5, ".pgsc") == 0;
+}
+
+inline bool salvarCena(const std::string &arquivo, const std::vector<VerticeCor> &vertices, int verticesPorForma)
+{
+	FILE *f = fopen(arquivo.c_str(), "wb");
+	if (!f)
+	{
+		std::cerr << "Erro ao criar arquivo de cena: " << arquivo << std::endl;
+		return false;
+	}
+
+	uint32_t nFormas = (uint32_t)(vertices.size() / verticesPorForma);
+	if (cenaEhBinaria(arquivo))
+	{
+		CabecalhoCena cab = {{'P', 'G', 'S', 'C'}, 1, nFormas, (uint32_t)verticesPorForma};
+		fwrite(&cab, sizeof(cab), 1, f);
+		fwrite(vertices.data(), sizeof(VerticeCor), vertices.size(), f);
+	}
+	else
+	{
+		fprintf(f, "PGSC-TEXTO 1\n%u %d\n", nFormas, verticesPorForma);
+		for (const VerticeCor &v : vertices)
+			fprintf(f, "%g %g %g %g %g %g\n", v.x, v.y, v.z, v.r, v.g, v.b);
+	}
+
+	fclose(f);
+	return true;
+}
+
+// Cena lida de arquivo. No binário, vertices aponta para dentro do arquivo mapeado
+// (válido enquanto a CenaCarregada existir); no texto, para textoLido.
+struct CenaCarregada {
+	ArquivoMapeado arquivo;
+	std::vector<VerticeCor> textoLido;
+	const VerticeCor *vertices = nullptr;
+	int nFormas = 0;
+	int verticesPorForma = 0;
+};
+
+inline bool carregarCena(const std::string &nome, CenaCarregada &cena)
+{
+	if (!cena.arquivo.abrir(nome))
+	{
+		std::cerr << "Erro ao abrir arquivo de cena: " << nome << std::endl;
+		return false;
+	}
+
+	const char *p = cena.arquivo.dados();
+	size_t tam = cena.arquivo.tamanho();
+
+	const char *magicTexto = "PGSC-TEXTO 1";
+	bool texto = tam >= strlen(magicTexto) && memcmp(p, magicTexto, strlen(magicTexto)) == 0;
+
+	if (!texto && tam >= sizeof(CabecalhoCena) && memcmp(p, "PGSC", 4) == 0)
+	{
+		CabecalhoCena cab;
+		memcpy(&cab, p, sizeof(cab));
+		size_t esperado = sizeof(cab) + (size_t)cab.nFormas * cab.verticesPorForma * sizeof(VerticeCor);
+		if (cab.versao != 1 || cab.verticesPorForma == 0 || tam != esperado)
+		{
+			std::cerr << "Erro: arquivo de cena binário inválido ou truncado: " << nome << std::endl;
+			return false;
+		}
+		cena.nFormas = (int)cab.nFormas;
+		cena.verticesPorForma = (int)cab.verticesPorForma;
+		cena.vertices = (const VerticeCor *)(p + sizeof(cab));
+		return true;
+	}
+
+	if (!texto)
+	{
+		std::cerr << "Erro: formato de cena desconhecido: " << nome << std::endl;
+		return false;
+	}
+
+	// Texto: o mapeamento não termina em '\0', então é copiado para uma string
+	std::string conteudo(p + strlen(magicTexto), tam - strlen(magicTexto));
+	cena.arquivo.fechar();
+
+	const char *q = conteudo.c_str();
+	char *fim;
+	cena.nFormas = (int)strtol(q, &fim, 10);
+	q = fim;
+	cena.verticesPorForma = (int)strtol(q, &fim, 10);
+	q = fim;
+	if (cena.nFormas < 0 || cena.verticesPorForma <= 0)
+	{
+		std::cerr << "Erro: cabeçalho de cena inválido: " << nome << std::endl;
+		return false;
+	}
+
+	cena.textoLido.resize((size_t)cena.nFormas * cena.verticesPorForma);
+	for (VerticeCor &v : cena.textoLido)
+	{
+		float *c = &v.x;
+		for (int k = 0; k < 6; k++)
+		{
+			c[k] = strtof(q, &fim);
+			if (fim == q)
+			{
+				std::cerr << "Erro: cena em texto incompleta: " << nome << std::endl;
+				return false;
+			}
+			q = fim;
+		}
+	}
+	cena.vertices = cena.textoLido.data();
+	return true;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <BufferStreaming.h>
+#include <Shader.h>
+
+// Desenha qualquer quantidade de retângulos coloridos com uma única chamada de
+// desenho. Cada retângulo vira uma instância de 20 bytes (centro, tamanho e cor
+// RGBA8) escrita num BufferStreaming (regiões em rodízio com fences, sem
+// glBufferData por frame); a geometria é um único quad unitário compartilhado.
+//
+//   batch.begin();
+//   batch.add(centro, tamanho, cor);   // quantas vezes for preciso
+//   batch.flush(projection);           // envia as instâncias e desenha
+//   batch.redesenhar(projection);      // desenha de novo sem reenviar nada
+//   glfwSwapBuffers(window);
+//   batch.fimDoFrame();                // fence da região usada no frame
+class ColorBatch {
+public:
+	struct Instancia {
+		float x, y;     // centro
+		float w, h;     // tamanho
+		uint8_t cor[4]; // RGBA normalizado no shader
+	};
+
+	bool init(size_t capacidadeInicial = 1024, bool permitirPersistente = true)
+	{
+		shaderID = compilar();
+		if (!shaderID)
+			return false;
+		projLoc = glGetUniformLocation(shaderID, "projection");
+
+		GLfloat quad[] = {
+			// x    y    z
+			-0.5, 0.5, 0.0,  // v0
+			-0.5, -0.5, 0.0, // v1
+			0.5, 0.5, 0.0,	 // v2
+			0.5, -0.5, 0.0	 // v3
+		};
+
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+
+		glGenBuffers(1, &quadVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
+		glEnableVertexAttribArray(0);
+
+		// Atributos por instância (divisor 1), apontados para o buffer de streaming
+		// a cada flush, já que a posição das instâncias muda de um frame para outro
+		if (!stream.init(capacidadeInicial * sizeof(Instancia), 3, permitirPersistente))
+			return false;
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		instancias.reserve(capacidadeInicial);
+		return true;
+	}
+
+	void begin() { instancias.clear(); }
+
+	void add(glm::vec2 centro, glm::vec2 tamanho, glm::vec4 cor)
+	{
+		Instancia inst;
+		inst.x = centro.x;
+		inst.y = centro.y;
+		inst.w = tamanho.x;
+		inst.h = tamanho.y;
+		inst.cor[0] = (uint8_t)(cor.r * 255.0f + 0.5f);
+		inst.cor[1] = (uint8_t)(cor.g * 255.0f + 0.5f);
+		inst.cor[2] = (uint8_t)(cor.b * 255.0f + 0.5f);
+		inst.cor[3] = (uint8_t)(cor.a * 255.0f + 0.5f);
+		instancias.push_back(inst);
+	}
+
+	void add(glm::vec2 centro, glm::vec2 tamanho, glm::vec3 cor) { add(centro, tamanho, glm::vec4(cor, 1.0f)); }
+
+	// Envia as instâncias acumuladas desde begin() e desenha todas
+	void flush(const glm::mat4 &projection)
+	{
+		enviadas = instancias.size();
+		if (enviadas == 0)
+			return;
+
+		size_t bytes = enviadas * sizeof(Instancia);
+		GLintptr deslocamento;
+		void *dst = stream.reservar(bytes, deslocamento);
+		memcpy(dst, instancias.data(), bytes);
+		stream.confirmar();
+
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instancia), (GLvoid *)(deslocamento + offsetof(Instancia, x)));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instancia), (GLvoid *)(deslocamento + offsetof(Instancia, cor)));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		redesenhar(projection);
+	}
+
+	// Desenha de novo as instâncias do último flush (nada é reenviado)
+	void redesenhar(const glm::mat4 &projection)
+	{
+		if (enviadas == 0)
+			return;
+
+		glUseProgram(shaderID);
+		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+		glBindVertexArray(VAO);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)enviadas);
+		glBindVertexArray(0);
+	}
+
+	// Depois do glfwSwapBuffers, em todo frame (com ou sem flush)
+	void fimDoFrame() { stream.fimDoFrame(); }
+
+	size_t size() const { return instancias.size(); }
+
+	// Bytes enviados e esperas pela GPU
+	const BufferStreaming &streaming() const { return stream; }
+
+private:
+	GLuint compilar()
+	{
+		const GLchar *vs = R"(
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 retangulo; // centro.xy, tamanho.zw
+layout (location = 2) in vec4 cor;
+uniform mat4 projection;
+out vec4 vCor;
+void main()
+{
+	vCor = cor;
+	gl_Position = projection * vec4(retangulo.xy + position.xy * retangulo.zw, 0.0, 1.0);
+}
+)";
+		const GLchar *fs = R"(
+#version 400
+in vec4 vCor;
+out vec4 color;
+void main()
+{
+	color = vCor;
+}
+)";
+		// setupShader mostra os logs de compilação e de link
+		return setupShader(vs, fs);
+	}
+
+	GLuint shaderID = 0, VAO = 0, quadVBO = 0;
+	GLint projLoc = -1;
+	BufferStreaming stream;
+	size_t enviadas = 0;
+	std::vector<Instancia> instancias;
+};
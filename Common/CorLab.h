@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Conversão sRGB -> CIELAB (iluminante D65) e as métricas de diferença de cor
+// ΔE76 e ΔE2000. Os canais vêm quantizados em 8 bits, então a conversão usa duas
+// tabelas: sRGB 8 bits -> linear (256 entradas) e f(t) = t^(1/3) do Lab (com
+// interpolação linear), evitando pow/cbrt por célula.
+
+struct CorLab {
+	float L, a, b;
+};
+
+class TabelaLab {
+public:
+	static const TabelaLab &instancia()
+	{
+		static TabelaLab tabela;
+		return tabela;
+	}
+
+	// cor em [0, 1], quantizada para 8 bits por canal
+	CorLab converter(glm::vec3 cor) const
+	{
+		float r = linear[quantizar(cor.r)];
+		float g = linear[quantizar(cor.g)];
+		float b = linear[quantizar(cor.b)];
+
+		// sRGB linear -> XYZ, já dividido pelo branco D65 (Xn, Yn, Zn)
+		float x = (0.4124564f * r + 0.3575761f * g + 0.1804375f * b) / 0.95047f;
+		float y = 0.2126729f * r + 0.7151522f * g + 0.0721750f * b;
+		float z = (0.0193339f * r + 0.1191920f * g + 0.9503041f * b) / 1.08883f;
+
+		float fx = f(x), fy = f(y), fz = f(z);
+		return {116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz)};
+	}
+
+private:
+	static const int N_F = 4096;
+
+	TabelaLab()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			double c = i / 255.0;
+			linear[i] = (float)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+		}
+		const double delta = 6.0 / 29.0;
+		for (int i = 0; i <= N_F; i++)
+		{
+			double t = (double)i / N_F;
+			tabelaF[i] = (float)(t > delta * delta * delta ? cbrt(t) : t / (3.0 * delta * delta) + 4.0 / 29.0);
+		}
+	}
+
+	static int quantizar(float c)
+	{
+		int q = (int)(c * 255.0f + 0.5f);
+		return q < 0 ? 0 : (q > 255 ? 255 : q);
+	}
+
+	float f(float t) const
+	{
+		float p = t * N_F;
+		if (p <= 0.0f)
+			return tabelaF[0];
+		if (p >= N_F)
+			return tabelaF[N_F];
+		int i = (int)p;
+		float frac = p - i;
+		return tabelaF[i] + (tabelaF[i + 1] - tabelaF[i]) * frac;
+	}
+
+	float linear[256];
+	float tabelaF[N_F + 1];
+};
+
+inline float deltaE76(const CorLab &c1, const CorLab &c2)
+{
+	float dL = c1.L - c2.L, da = c1.a - c2.a, db = c1.b - c2.b;
+	return std::sqrt(dL * dL + da * da + db * db);
+}
+
+// CIEDE2000 (Sharma, Wu e Dalal, 2005), com kL = kC = kH = 1
+inline float deltaE2000(const CorLab &c1, const CorLab &c2)
+{
+	const double PI = 3.14159265358979323846;
+	const double pow25_7 = 6103515625.0; // 25^7
+
+	double C1 = std::sqrt((double)c1.a * c1.a + (double)c1.b * c1.b);
+	double C2 = std::sqrt((double)c2.a * c2.a + (double)c2.b * c2.b);
+	double Cm = (C1 + C2) / 2.0;
+	double Cm7 = std::pow(Cm, 7.0);
+	double G = 0.5 * (1.0 - std::sqrt(Cm7 / (Cm7 + pow25_7)));
+
+	double a1 = (1.0 + G) * c1.a, a2 = (1.0 + G) * c2.a;
+	double C1p = std::sqrt(a1 * a1 + (double)c1.b * c1.b);
+	double C2p = std::sqrt(a2 * a2 + (double)c2.b * c2.b);
+	double h1p = (a1 == 0.0 && c1.b == 0.0) ? 0.0 : std::atan2((double)c1.b, a1);
+	double h2p = (a2 == 0.0 && c2.b == 0.0) ? 0.0 : std::atan2((double)c2.b, a2);
+	if (h1p < 0.0) h1p += 2.0 * PI;
+	if (h2p < 0.0) h2p += 2.0 * PI;
+
+	double dLp = (double)c2.L - c1.L;
+	double dCp = C2p - C1p;
+	double dhp = 0.0;
+	if (C1p * C2p != 0.0)
+	{
+		dhp = h2p - h1p;
+		if (dhp > PI) dhp -= 2.0 * PI;
+		else if (dhp < -PI) dhp += 2.0 * PI;
+	}
+	double dHp = 2.0 * std::sqrt(C1p * C2p) * std::sin(dhp / 2.0);
+
+	double Lm = ((double)c1.L + c2.L) / 2.0;
+	double Cmp = (C1p + C2p) / 2.0;
+	double hmp = h1p + h2p;
+	if (C1p * C2p != 0.0)
+	{
+		if (std::fabs(h1p - h2p) > PI)
+			hmp += hmp < 2.0 * PI ? 2.0 * PI : -2.0 * PI;
+		hmp /= 2.0;
+	}
+
+	double T = 1.0 - 0.17 * std::cos(hmp - PI / 6.0) + 0.24 * std::cos(2.0 * hmp) +
+			   0.32 * std::cos(3.0 * hmp + PI / 30.0) - 0.20 * std::cos(4.0 * hmp - 63.0 * PI / 180.0);
+	double dTheta = (30.0 * PI / 180.0) * std::exp(-std::pow((hmp * 180.0 / PI - 275.0) / 25.0, 2.0));
+	double Cmp7 = std::pow(Cmp, 7.0);
+	double RC = 2.0 * std::sqrt(Cmp7 / (Cmp7 + pow25_7));
+	double Lm50 = (Lm - 50.0) * (Lm - 50.0);
+	double SL = 1.0 + 0.015 * Lm50 / std::sqrt(20.0 + Lm50);
+	double SC = 1.0 + 0.045 * Cmp;
+	double SH = 1.0 + 0.015 * Cmp * T;
+	double RT = -std::sin(2.0 * dTheta) * RC;
+
+	double tL = dLp / SL, tC = dCp / SC, tH = dHp / SH;
+	return (float)std::sqrt(tL * tL + tC * tC + tH * tH + RT * tC * tH);
+}
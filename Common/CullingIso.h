@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// Culling de um mapa isométrico em losango: quais tiles podem aparecer num retângulo
+// do mundo (a janela da câmera). O tile [i][j] ocupa x0 + (j - i) * tileW/2 e
+// y0 + (j + i) * tileH/2, então o retângulo limita d = j - i e s = j + i; as linhas
+// visíveis vão de iMin a iMax e, em cada uma, as colunas de jMin(i) a jMax(i).
+// A margem (em tiles) cobre o que é desenhado além do losango, como o sprite.
+//
+//   FaixaIso faixa = faixaVisivelIso(x0, y0, tileW, tileH, linhas, colunas, xMin, xMax, yMin, yMax);
+//   for (int i = faixa.iMin; i <= faixa.iMax; i++)
+//       for (int j = faixa.jMin(i); j <= faixa.jMax(i); j++)
+//           ...
+struct FaixaIso {
+	int dMin, dMax, sMin, sMax;
+	int iMin, iMax;
+	int colunas;
+
+	int jMin(int i) const { return std::max({0, dMin + i, sMin - i}); }
+	int jMax(int i) const { return std::min({colunas - 1, dMax + i, sMax - i}); }
+};
+
+inline FaixaIso faixaVisivelIso(float x0, float y0, float tileW, float tileH, int linhas, int colunas,
+								float xMin, float xMax, float yMin, float yMax, int margem = 2)
+{
+	FaixaIso f;
+	f.dMin = (int)std::floor((xMin - x0 - tileW) / (tileW / 2.0f)) - margem;
+	f.dMax = (int)std::ceil((xMax - x0) / (tileW / 2.0f)) + margem;
+	f.sMin = (int)std::floor((yMin - y0 - tileH) / (tileH / 2.0f)) - margem;
+	f.sMax = (int)std::ceil((yMax - y0) / (tileH / 2.0f)) + margem;
+
+	f.iMin = std::max(0, (int)std::floor((f.sMin - f.dMax) / 2.0f));
+	f.iMax = std::min(linhas - 1, (int)std::ceil((f.sMax - f.dMin) / 2.0f));
+	f.colunas = colunas;
+	return f;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Texto como string JSON (sem as aspas): escapa aspas, barras invertidas e caracteres
+// de controle de nomes vindos da linha de comando (--rotulo, caminhos, ...)
+inline std::string textoJson(const std::string &texto)
+{
+	std::string saida;
+	saida.reserve(texto.size());
+	for (unsigned char c : texto)
+	{
+		if (c == '"' || c == '\\')
+		{
+			saida += '\\';
+			saida += (char)c;
+		}
+		else if (c < 0x20)
+		{
+			char codigo[8];
+			snprintf(codigo, sizeof(codigo), "\\u%04x", c);
+			saida += codigo;
+		}
+		else
+			saida += (char)c;
+	}
+	return saida;
+}
+
+// Coleta os tempos de frame de uma sessão e escreve um resumo em JSON, no formato
+// consumido pelo acompanhamento de desempenho do CI:
+//   {"programa": "...", "frames": N, "total_s": ..., "media_ms": ...,
+//    "p50_ms": ..., "p95_ms": ..., "p99_ms": ..., "max_ms": ...}
+// Contadores somados com somarContador (chamadas OpenGL, ...) entram como média por
+// frame: ..., "contadores": {"gl_draws": ..., ...}}
+class FrameReport {
+public:
+	void reservar(size_t n) { tempos.reserve(n); }
+
+	void registrar(double segundos) { tempos.push_back(segundos * 1000.0); }
+
+	size_t frames() const { return tempos.size(); }
+
+	// nome como const char *: chamado todo frame, sem montar std::string
+	void somarContador(const char *nome, double valor)
+	{
+		for (auto &c : contadores)
+			if (c.first == nome) {
+				c.second += valor;
+				return;
+			}
+		contadores.emplace_back(nome, valor);
+	}
+
+	bool salvarJson(const std::string &arquivo, const std::string &programa) const
+	{
+		FILE *f = fopen(arquivo.c_str(), "w");
+		if (!f)
+			return false;
+
+		std::vector<double> ordenados = tempos;
+		std::sort(ordenados.begin(), ordenados.end());
+
+		double total = 0.0;
+		for (double t : ordenados)
+			total += t;
+
+		double media = ordenados.empty() ? 0.0 : total / ordenados.size();
+		fprintf(f, "{\"programa\": \"%s\", \"frames\": %zu, \"total_s\": %.6f, \"media_ms\": %.4f, "
+				   "\"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f",
+				textoJson(programa).c_str(), ordenados.size(), total / 1000.0, media,
+				percentil(ordenados, 0.50), percentil(ordenados, 0.95), percentil(ordenados, 0.99),
+				ordenados.empty() ? 0.0 : ordenados.back());
+		if (!contadores.empty()) {
+			fprintf(f, ", \"contadores\": {");
+			for (size_t k = 0; k < contadores.size(); k++)
+				fprintf(f, "%s\"%s\": %.2f", k ? ", " : "", textoJson(contadores[k].first).c_str(),
+						ordenados.empty() ? 0.0 : contadores[k].second / ordenados.size());
+			fprintf(f, "}");
+		}
+		fprintf(f, "}\n");
+		fclose(f);
+		return true;
+	}
+
+	// Percentil por posição mais próxima sobre um vetor já ordenado
+	static double percentil(const std::vector<double> &ordenados, double p)
+	{
+		if (ordenados.empty())
+			return 0.0;
+		size_t i = (size_t)(p * (ordenados.size() - 1) + 0.5);
+		return ordenados[std::min(i, ordenados.size() - 1)];
+	}
+
+private:
+	std::vector<double> tempos;
+	std::vector<std::pair<std::string, double>> contadores;
+};
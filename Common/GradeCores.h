@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <CorLab.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GRADE_CORES_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GRADE_CORES_ALVO_AVX2
+#else
+#define GRADE_CORES_ALVO_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Cores de uma grade guardadas em estrutura de arrays (SoA): r, g e b em arrays
+// float separados e um bit de "eliminado" por célula. A eliminação por semelhança
+// compara distâncias ao quadrado com o limiar já elevado ao quadrado (sem sqrt/pow)
+// e processa 64 células por palavra da máscara, com kernels AVX2/SSE escolhidos
+// em tempo de execução e um kernel escalar portátil.
+//
+// Cada cor também é convertida para CIELAB ao ser definida (ver CorLab.h) e
+// guardada em L, a, b, também em SoA. ΔE76 é a distância euclidiana em Lab, então
+// usa os mesmos kernels; ΔE2000 é escalar. Em grades grandes a consulta é dividida
+// entre as threads da máquina, cada uma com uma faixa própria de palavras da máscara.
+//
+// Os arrays são preenchidos até múltiplo de 64; as células de preenchimento já
+// nascem eliminadas e nunca são contadas.
+
+enum KernelCores { KERNEL_ESCALAR = 0, KERNEL_SSE, KERNEL_AVX2 };
+enum MetricaCor { METRICA_RGB = 0, METRICA_DE76, METRICA_DE2000 };
+
+class GradeCores {
+public:
+	void redimensionar(size_t n)
+	{
+		total = n;
+		size_t palavras = (n + 63) / 64;
+		r.assign(palavras * 64, 0.0f);
+		g.assign(palavras * 64, 0.0f);
+		b.assign(palavras * 64, 0.0f);
+		labL.assign(palavras * 64, 0.0f);
+		labA.assign(palavras * 64, 0.0f);
+		labB.assign(palavras * 64, 0.0f);
+		reviverTodas();
+		if (kernel < 0)
+			kernel = melhorKernel();
+	}
+
+	// Limpa todas as marcas de eliminado (as cores são mantidas)
+	void reviverTodas()
+	{
+		eliminados.assign((total + 63) / 64, 0);
+		if (total % 64)
+			eliminados.back() = ~0ull << (total % 64);
+	}
+
+	size_t size() const { return total; }
+
+	void definir(size_t k, glm::vec3 cor)
+	{
+		r[k] = cor.r;
+		g[k] = cor.g;
+		b[k] = cor.b;
+		CorLab lab = TabelaLab::instancia().converter(cor);
+		labL[k] = lab.L;
+		labA[k] = lab.a;
+		labB[k] = lab.b;
+		eliminados[k / 64] &= ~(1ull << (k % 64));
+	}
+
+	glm::vec3 cor(size_t k) const { return glm::vec3(r[k], g[k], b[k]); }
+	CorLab lab(size_t k) const { return {labL[k], labA[k], labB[k]}; }
+	bool eliminado(size_t k) const { return (eliminados[k / 64] >> (k % 64)) & 1; }
+	void eliminar(size_t k) { eliminados[k / 64] |= 1ull << (k % 64); }
+
+	// Elimina as células ainda vivas cuja distância RGB ao quadrado até cor é
+	// <= limiarQuadrado. Retorna quantas foram eliminadas agora.
+	size_t eliminarSimilares(glm::vec3 cor, float limiarQuadrado)
+	{
+		return emParalelo([&](size_t w0, size_t w1) {
+			return eliminarFaixa(r.data(), g.data(), b.data(), cor, limiarQuadrado, w0, w1);
+		});
+	}
+
+	// Elimina as células a até limiar (em unidades de ΔE) da cor Lab alvo
+	size_t eliminarSimilares(const CorLab &alvo, float limiar, MetricaCor metrica)
+	{
+		if (metrica == METRICA_DE76)
+		{
+			glm::vec3 v(alvo.L, alvo.a, alvo.b);
+			return emParalelo([&](size_t w0, size_t w1) {
+				return eliminarFaixa(labL.data(), labA.data(), labB.data(), v, limiar * limiar, w0, w1);
+			});
+		}
+		return emParalelo([&](size_t w0, size_t w1) { return eliminarDE2000(alvo, limiar, w0, w1); });
+	}
+
+	// Número de threads das consultas (0 = automático, conforme a CPU e o tamanho da grade)
+	void definirThreads(unsigned n) { threads = n; }
+
+	// Troca o kernel usado (para comparação); retorna false se a CPU não suporta
+	bool usarKernel(KernelCores k)
+	{
+		if (!kernelDisponivel(k))
+			return false;
+		kernel = k;
+		return true;
+	}
+
+	KernelCores kernelAtual() const { return (KernelCores)(kernel < 0 ? melhorKernel() : kernel); }
+
+	static bool kernelDisponivel(KernelCores k)
+	{
+		if (k == KERNEL_ESCALAR)
+			return true;
+#ifdef GRADE_CORES_X86
+		if (k == KERNEL_SSE)
+			return true; // SSE2 faz parte da base de x86-64
+		if (k == KERNEL_AVX2)
+			return suportaAVX2();
+#endif
+		return false;
+	}
+
+	static KernelCores melhorKernel()
+	{
+		if (kernelDisponivel(KERNEL_AVX2))
+			return KERNEL_AVX2;
+		if (kernelDisponivel(KERNEL_SSE))
+			return KERNEL_SSE;
+		return KERNEL_ESCALAR;
+	}
+
+	static const char *nomeKernel(KernelCores k)
+	{
+		static const char *nomes[] = {"escalar", "SSE", "AVX2"};
+		return nomes[k];
+	}
+
+private:
+	// Marca as células que casaram e ainda estavam vivas; retorna quantas eram
+	size_t aplicarMascara(size_t w, uint64_t casou)
+	{
+		uint64_t novos = casou & ~eliminados[w];
+		eliminados[w] |= novos;
+		return std::bitset<64>(novos).count();
+	}
+
+	// Divide as palavras da máscara entre threads; faixa(w0, w1) devolve quantas
+	// células eliminou. Faixas disjuntas não compartilham palavras, então não há corrida.
+	template <class F>
+	size_t emParalelo(F &&faixa)
+	{
+		const size_t palavras = eliminados.size();
+		unsigned n = threads;
+		if (n == 0)
+		{
+			const size_t CELULAS_POR_THREAD = 1 << 18;
+			n = std::max(1u, std::thread::hardware_concurrency());
+			n = (unsigned)std::min<size_t>(n, total / CELULAS_POR_THREAD + 1);
+		}
+		n = (unsigned)std::min<size_t>(n, std::max<size_t>(palavras, 1));
+		if (n <= 1)
+			return faixa(0, palavras);
+
+		std::vector<std::thread> trabalhadores;
+		std::vector<size_t> parciais(n, 0);
+		size_t porThread = (palavras + n - 1) / n;
+		for (unsigned t = 0; t < n; t++)
+		{
+			size_t w0 = std::min(palavras, t * porThread), w1 = std::min(palavras, w0 + porThread);
+			trabalhadores.emplace_back([&, t, w0, w1]() { parciais[t] = faixa(w0, w1); });
+		}
+		size_t soma = 0;
+		for (unsigned t = 0; t < n; t++)
+		{
+			trabalhadores[t].join();
+			soma += parciais[t];
+		}
+		return soma;
+	}
+
+	size_t eliminarFaixa(const float *x, const float *y, const float *z, glm::vec3 alvo, float limiarQuadrado,
+						 size_t w0, size_t w1)
+	{
+		switch (kernel)
+		{
+#ifdef GRADE_CORES_X86
+		case KERNEL_AVX2:
+			return eliminarAVX2(x, y, z, alvo, limiarQuadrado, w0, w1);
+		case KERNEL_SSE:
+			return eliminarSSE(x, y, z, alvo, limiarQuadrado, w0, w1);
+#endif
+		default:
+			return eliminarEscalar(x, y, z, alvo, limiarQuadrado, w0, w1);
+		}
+	}
+
+	size_t eliminarDE2000(const CorLab &alvo, float limiar, size_t w0, size_t w1)
+	{
+		size_t n = 0;
+		for (size_t w = w0; w < w1; w++)
+		{
+			uint64_t casou = 0;
+			for (int k = 0; k < 64; k++)
+			{
+				// ΔE2000 é caro: só para as células ainda vivas
+				if (!((eliminados[w] >> k) & 1) && deltaE2000(alvo, lab(w * 64 + k)) <= limiar)
+					casou |= 1ull << k;
+			}
+			n += aplicarMascara(w, casou);
+		}
+		return n;
+	}
+
+	size_t eliminarEscalar(const float *x, const float *y, const float *z, glm::vec3 alvo, float limiarQuadrado,
+						   size_t w0, size_t w1)
+	{
+		size_t n = 0;
+		for (size_t w = w0; w < w1; w++)
+		{
+			uint64_t casou = 0;
+			size_t base = w * 64;
+			for (int k = 0; k < 64; k++)
+			{
+				float dr = x[base + k] - alvo.x;
+				float dg = y[base + k] - alvo.y;
+				float db = z[base + k] - alvo.z;
+				float d2 = dr * dr + dg * dg + db * db;
+				casou |= (uint64_t)(d2 <= limiarQuadrado) << k;
+			}
+			n += aplicarMascara(w, casou);
+		}
+		return n;
+	}
+
+#ifdef GRADE_CORES_X86
+	size_t eliminarSSE(const float *x, const float *y, const float *z, glm::vec3 alvo, float limiarQuadrado,
+					   size_t w0, size_t w1)
+	{
+		const __m128 cr = _mm_set1_ps(alvo.x), cg = _mm_set1_ps(alvo.y), cb = _mm_set1_ps(alvo.z);
+		const __m128 lim = _mm_set1_ps(limiarQuadrado);
+		size_t n = 0;
+		for (size_t w = w0; w < w1; w++)
+		{
+			uint64_t casou = 0;
+			size_t base = w * 64;
+			for (int k = 0; k < 64; k += 4)
+			{
+				__m128 dr = _mm_sub_ps(_mm_loadu_ps(x + base + k), cr);
+				__m128 dg = _mm_sub_ps(_mm_loadu_ps(y + base + k), cg);
+				__m128 db = _mm_sub_ps(_mm_loadu_ps(z + base + k), cb);
+				__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+				casou |= (uint64_t)_mm_movemask_ps(_mm_cmple_ps(d2, lim)) << k;
+			}
+			n += aplicarMascara(w, casou);
+		}
+		return n;
+	}
+
+	// Mesma sequência de operações do kernel escalar (sem FMA), então os três
+	// kernels eliminam exatamente as mesmas células
+	GRADE_CORES_ALVO_AVX2 size_t eliminarAVX2(const float *x, const float *y, const float *z, glm::vec3 alvo,
+											  float limiarQuadrado, size_t w0, size_t w1)
+	{
+		const __m256 cr = _mm256_set1_ps(alvo.x), cg = _mm256_set1_ps(alvo.y), cb = _mm256_set1_ps(alvo.z);
+		const __m256 lim = _mm256_set1_ps(limiarQuadrado);
+		size_t n = 0;
+		for (size_t w = w0; w < w1; w++)
+		{
+			uint64_t casou = 0;
+			size_t base = w * 64;
+			for (int k = 0; k < 64; k += 8)
+			{
+				__m256 dr = _mm256_sub_ps(_mm256_loadu_ps(x + base + k), cr);
+				__m256 dg = _mm256_sub_ps(_mm256_loadu_ps(y + base + k), cg);
+				__m256 db = _mm256_sub_ps(_mm256_loadu_ps(z + base + k), cb);
+				__m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dr, dr), _mm256_mul_ps(dg, dg)), _mm256_mul_ps(db, db));
+				casou |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(d2, lim, _CMP_LE_OQ)) << k;
+			}
+			n += aplicarMascara(w, casou);
+		}
+		return n;
+	}
+
+	static bool suportaAVX2()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+			return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	std::vector<float> r, g, b;
+	std::vector<float> labL, labA, labB;
+	std::vector<uint64_t> eliminados;
+	size_t total = 0;
+	int kernel = -1;
+	unsigned threads = 0;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include <InputQueue.h>
+
+// Log binário de entrada para sessões reproduzíveis
+//
+// Cabeçalho (20 bytes): "PGIR", versão, semente do RNG, passo fixo e total de frames
+// Em seguida um registro de 20 bytes por evento, na ordem em que foram consumidos:
+//   frame (u32) | tipo (u8) | action (u8) | mods (u16) | key (i32) | x (f32) | y (f32)
+// O frame é o índice do passo de simulação em que o evento foi consumido, então a
+// reprodução entrega cada evento exatamente no mesmo passo em que ele foi gravado.
+
+#pragma pack(push, 1)
+struct CabecalhoLogEntrada {
+	char magic[4];
+	uint32_t versao;
+	uint32_t semente;
+	float passoFixo;
+	uint32_t totalFrames;
+};
+
+struct RegistroLogEntrada {
+	uint32_t frame;
+	uint8_t tipo;
+	uint8_t action;
+	uint16_t mods;
+	int32_t key;
+	float x, y;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CabecalhoLogEntrada) == 20, "cabecalho do log deve ter 20 bytes");
+static_assert(sizeof(RegistroLogEntrada) == 20, "registro do log deve ter 20 bytes");
+
+// Opções de linha de comando comuns aos programas que suportam gravação/reprodução
+//   --gravar <arq>      grava a sessão ao vivo em <arq>
+//   --reproduzir <arq>  reproduz <arq> em passo fixo, ignorando o teclado
+//   --relatorio <arq>   escreve o relatório de tempos de frame (JSON) ao sair
+//   --headless          cria a janela invisível
+//   --semente <n>       força a semente do RNG (sessões ao vivo)
+struct OpcoesSessao {
+	std::string arquivoGravacao;
+	std::string arquivoReproducao;
+	std::string arquivoRelatorio;
+	bool headless = false;
+	bool sementeFixa = false;
+	uint32_t semente = 0;
+};
+
+inline OpcoesSessao lerOpcoesSessao(int argc, char **argv)
+{
+	OpcoesSessao op;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool temValor = i + 1 < argc;
+		if (arg == "--gravar" && temValor) op.arquivoGravacao = argv[++i];
+		else if (arg == "--reproduzir" && temValor) op.arquivoReproducao = argv[++i];
+		else if (arg == "--relatorio" && temValor) op.arquivoRelatorio = argv[++i];
+		else if (arg == "--semente" && temValor) { op.semente = (uint32_t)strtoul(argv[++i], nullptr, 10); op.sementeFixa = true; }
+		else if (arg == "--headless") op.headless = true;
+	}
+	return op;
+}
+
+// Fonte única de eventos para o passo de simulação: ao vivo (opcionalmente gravando)
+// ou vinda de um log gravado anteriormente
+class SessaoEntrada {
+public:
+	~SessaoEntrada() { finalizar(); }
+
+	// Abre os arquivos pedidos nas opções e define a semente do RNG da sessão.
+	// passoFixo é o passo de simulação usado na reprodução (e gravado no log).
+	bool iniciar(const OpcoesSessao &op, float passoFixo)
+	{
+		passo = passoFixo;
+		semente = op.sementeFixa ? op.semente : (uint32_t)time(0);
+
+		if (!op.arquivoReproducao.empty())
+		{
+			entrada = fopen(op.arquivoReproducao.c_str(), "rb");
+			CabecalhoLogEntrada cab;
+			if (!entrada || fread(&cab, sizeof(cab), 1, entrada) != 1 || memcmp(cab.magic, "PGIR", 4) != 0 || cab.versao != 1)
+			{
+				std::cerr << "Erro ao abrir log de entrada: " << op.arquivoReproducao << std::endl;
+				return false;
+			}
+			semente = cab.semente;
+			passo = cab.passoFixo;
+			totalFrames = cab.totalFrames;
+			temPendente = fread(&pendente, sizeof(pendente), 1, entrada) == 1;
+		}
+		else if (!op.arquivoGravacao.empty())
+		{
+			saida = fopen(op.arquivoGravacao.c_str(), "wb");
+			if (!saida)
+			{
+				std::cerr << "Erro ao criar log de entrada: " << op.arquivoGravacao << std::endl;
+				return false;
+			}
+			// totalFrames é reescrito em finalizar()
+			CabecalhoLogEntrada cab = {{'P', 'G', 'I', 'R'}, 1, semente, passo, 0};
+			fwrite(&cab, sizeof(cab), 1, saida);
+		}
+		return true;
+	}
+
+	// Entrega a aplicar() os eventos do frame atual. Na reprodução os eventos ao vivo
+	// são descartados para não contaminar a sessão gravada.
+	template <size_t N, class F>
+	void consumir(InputQueue<N> &fila, F &&aplicar)
+	{
+		InputEvent ev;
+		if (entrada)
+		{
+			while (fila.pop(ev)) {}
+			while (temPendente && pendente.frame == frame)
+			{
+				ev.time = frame * passo;
+				ev.tipo = pendente.tipo;
+				ev.action = pendente.action;
+				ev.mods = pendente.mods;
+				ev.key = pendente.key;
+				ev.x = pendente.x;
+				ev.y = pendente.y;
+				aplicar(ev);
+				temPendente = fread(&pendente, sizeof(pendente), 1, entrada) == 1;
+			}
+			return;
+		}
+
+		while (fila.pop(ev))
+		{
+			if (saida)
+			{
+				RegistroLogEntrada r = {frame, (uint8_t)ev.tipo, (uint8_t)ev.action, (uint16_t)ev.mods,
+										ev.key, (float)ev.x, (float)ev.y};
+				fwrite(&r, sizeof(r), 1, saida);
+			}
+			aplicar(ev);
+		}
+	}
+
+	void fimDoFrame() { frame++; }
+
+	// Na reprodução a sessão termina quando todos os frames gravados foram executados
+	bool terminou() const { return entrada && frame >= totalFrames; }
+
+	void finalizar()
+	{
+		if (saida)
+		{
+			fseek(saida, offsetof(CabecalhoLogEntrada, totalFrames), SEEK_SET);
+			fwrite(&frame, sizeof(frame), 1, saida);
+			fclose(saida);
+			saida = nullptr;
+		}
+		if (entrada)
+		{
+			fclose(entrada);
+			entrada = nullptr;
+		}
+	}
+
+	bool reproduzindo() const { return entrada != nullptr; }
+	uint32_t sementeSessao() const { return semente; }
+	float passoFixo() const { return passo; }
+	uint32_t frameAtual() const { return frame; }
+	uint32_t framesGravados() const { return totalFrames; }
+
+private:
+	FILE *entrada = nullptr;
+	FILE *saida = nullptr;
+	RegistroLogEntrada pendente;
+	bool temPendente = false;
+	uint32_t semente = 0;
+	uint32_t frame = 0;
+	uint32_t totalFrames = 0;
+	float passo = 1.0f / 60.0f;
+};
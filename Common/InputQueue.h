@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+enum TipoEvento {
+	EVENTO_TECLA = 0,
+	EVENTO_MOUSE = 1,
+	EVENTO_SCROLL = 2
+};
+
+// Evento de entrada bruto, exatamente como chegou do callback da GLFW
+struct InputEvent {
+	double time;   // instante (glfwGetTime) em que o evento chegou
+	int key;       // tecla ou botão do mouse
+	int action;
+	int mods;
+	int tipo = EVENTO_TECLA;
+	double x = 0.0, y = 0.0; // posição do cursor (EVENTO_MOUSE) ou deslocamento (EVENTO_SCROLL)
+};
+
+// Fila circular sem travas para um produtor (callback de input) e um consumidor
+// (passo de simulação). O callback só copia o evento e retorna: nenhuma lógica de
+// jogo, I/O ou alocação acontece no caminho crítico da entrada.
+// CAPACIDADE precisa ser potência de 2 para o índice ser calculado com máscara.
+template <size_t CAPACIDADE>
+class InputQueue {
+	static_assert((CAPACIDADE & (CAPACIDADE - 1)) == 0, "CAPACIDADE deve ser potencia de 2");
+
+public:
+	// Retorna false se a fila estiver cheia (o evento é descartado e contado)
+	bool push(const InputEvent &ev)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t h = head.load(std::memory_order_acquire);
+		if (t - h == CAPACIDADE) {
+			descartados.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		buffer[t & (CAPACIDADE - 1)] = ev;
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(InputEvent &ev)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		size_t t = tail.load(std::memory_order_acquire);
+		if (h == t)
+			return false;
+		ev = buffer[h & (CAPACIDADE - 1)];
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t size() const
+	{
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+
+	size_t eventosDescartados() const { return descartados.load(std::memory_order_relaxed); }
+
+private:
+	InputEvent buffer[CAPACIDADE];
+	std::atomic<size_t> head{0};
+	std::atomic<size_t> tail{0};
+	std::atomic<size_t> descartados{0};
+};
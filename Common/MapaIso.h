@@ -0,0 +1,304 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Mapa isométrico carregado de arquivo, compartilhado pelo jogo (GrauB) e pelas
+// ferramentas. Dois formatos são aceitos por carregarMapa:
+//
+// Texto (map.txt):
+//   <tileset> <nTiles> <tileWidth> <tileHeight>
+//   <largura> <altura>
+//   <altura linhas com largura IDs cada>
+//   --
+//   TileProperties
+//   <changeTile> <hazard> <collectible>     (uma linha por tile)
+//
+// Binário (.pgmap), bem mais rápido para mapas grandes:
+//   "PGMB" | versao u32 | largura u32 | altura u32 | nTiles u32 | tileWidth u32 |
+//   tileHeight u32 | nProps u32 | tamanho do nome u32 | nome do tileset |
+//   nProps x 3 bytes (change, hazard, collectible) | largura*altura IDs u16
+
+struct TileProperties {
+	bool isChangeTile;
+	bool isHazard;
+	bool isCollectible;
+};
+
+struct MapaIso {
+	std::string tilesetFile;
+	int nTiles = 0;
+	int tileWidth = 0, tileHeight = 0;
+	int largura = 0, altura = 0;
+	std::vector<uint16_t> tiles; // linha a linha: tiles[i * largura + j]
+	std::vector<TileProperties> props;
+
+	uint16_t &at(int i, int j) { return tiles[(size_t)i * largura + j]; }
+	uint16_t at(int i, int j) const { return tiles[(size_t)i * largura + j]; }
+};
+
+namespace mapa_detalhe {
+
+inline bool lerArquivo(const std::string &arquivo, std::vector<char> &conteudo)
+{
+	FILE *f = fopen(arquivo.c_str(), "rb");
+	if (!f)
+		return false;
+	fseek(f, 0, SEEK_END);
+	long tamanho = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	conteudo.resize((size_t)tamanho + 1);
+	size_t lidos = fread(conteudo.data(), 1, (size_t)tamanho, f);
+	fclose(f);
+	conteudo[lidos] = '\0';
+	return lidos == (size_t)tamanho;
+}
+
+inline void pularEspacos(const char *&p)
+{
+	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+		p++;
+}
+
+// Lê um inteiro sem sinal a partir de p (sem passar por stringstream/locale).
+// Um número que não cabe em int é rejeitado.
+inline bool lerInt(const char *&p, int &v)
+{
+	pularEspacos(p);
+	if (*p < '0' || *p > '9')
+		return false;
+	int r = 0;
+	while (*p >= '0' && *p <= '9')
+	{
+		int d = *p++ - '0';
+		if (r > (INT_MAX - d) / 10)
+			return false;
+		r = r * 10 + d;
+	}
+	v = r;
+	return true;
+}
+
+inline std::string lerPalavra(const char *&p)
+{
+	pularEspacos(p);
+	const char *ini = p;
+	while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+		p++;
+	return std::string(ini, p);
+}
+
+inline bool carregarMapaTexto(const std::vector<char> &conteudo, MapaIso &mapa)
+{
+	const char *p = conteudo.data();
+
+	mapa.tilesetFile = lerPalavra(p);
+	if (!lerInt(p, mapa.nTiles) || !lerInt(p, mapa.tileWidth) || !lerInt(p, mapa.tileHeight) ||
+		!lerInt(p, mapa.largura) || !lerInt(p, mapa.altura))
+	{
+		std::cerr << "Erro: cabeçalho do mapa inválido" << std::endl;
+		return false;
+	}
+	// Os mesmos limites do binário; cada ID ocupa ao menos um dígito e um separador,
+	// então um cabeçalho maior que o arquivo é rejeitado antes de alocar a matriz
+	if (mapa.nTiles > 65536 || (uint64_t)mapa.largura * mapa.altura > conteudo.size() / 2)
+	{
+		std::cerr << "Erro: cabeçalho do mapa inválido (" << mapa.largura << "x" << mapa.altura << ", "
+				  << mapa.nTiles << " tiles)" << std::endl;
+		return false;
+	}
+
+	mapa.tiles.resize((size_t)mapa.largura * mapa.altura);
+	for (size_t k = 0; k < mapa.tiles.size(); k++)
+	{
+		int id;
+		if (!lerInt(p, id))
+		{
+			std::cerr << "Erro: matriz do mapa incompleta" << std::endl;
+			return false;
+		}
+		if (id < 0 || id >= mapa.nTiles)
+		{
+			std::cerr << "Erro: tile " << id << " fora do tileset (" << mapa.nTiles << " tiles)" << std::endl;
+			return false;
+		}
+		mapa.tiles[k] = (uint16_t)id;
+	}
+
+	const char *secao = strstr(p, "--");
+	if (secao)
+		secao = strstr(secao, "TileProperties");
+	if (!secao)
+	{
+		std::cerr << "Erro: seção TileProperties não encontrada" << std::endl;
+		return false;
+	}
+	p = secao + strlen("TileProperties");
+
+	// Uma linha por tile; linhas que não começam com número (comentários) são ignoradas
+	mapa.props.clear();
+	while (*p)
+	{
+		const char *fimLinha = strchr(p, '\n');
+		if (!fimLinha)
+			fimLinha = p + strlen(p);
+
+		int change, hazard, collectible;
+		const char *q = p;
+		if (lerInt(q, change) && lerInt(q, hazard) && lerInt(q, collectible) && q <= fimLinha)
+			mapa.props.push_back({change != 0, hazard != 0, collectible != 0});
+
+		p = *fimLinha ? fimLinha + 1 : fimLinha;
+	}
+	return true;
+}
+
+inline bool carregarMapaBinario(const std::vector<char> &conteudo, MapaIso &mapa)
+{
+	const char *p = conteudo.data();
+	const char *fim = p + conteudo.size() - 1;
+	uint32_t cab[9];
+	if (fim - p < (long)sizeof(cab))
+		return false;
+	memcpy(cab, p, sizeof(cab));
+	p += sizeof(cab);
+
+	if (cab[1] != 1)
+	{
+		std::cerr << "Erro: versão de mapa binário não suportada: " << cab[1] << std::endl;
+		return false;
+	}
+	// Dimensões que não cabem em int (ou IDs que não cabem em u16) só vêm de arquivo corrompido
+	if (cab[2] > INT_MAX || cab[3] > INT_MAX || cab[4] > 65536)
+	{
+		std::cerr << "Erro: cabeçalho do mapa binário inválido" << std::endl;
+		return false;
+	}
+	mapa.largura = (int)cab[2];
+	mapa.altura = (int)cab[3];
+	mapa.nTiles = (int)cab[4];
+	mapa.tileWidth = (int)cab[5];
+	mapa.tileHeight = (int)cab[6];
+	uint32_t nProps = cab[7], tamNome = cab[8];
+
+	// Em 64 bits: com u32 o nome e as propriedades de um arquivo corrompido dariam a volta
+	uint64_t nCelulas = (uint64_t)mapa.largura * mapa.altura;
+	if ((uint64_t)(fim - p) != (uint64_t)tamNome + (uint64_t)nProps * 3 + nCelulas * sizeof(uint16_t))
+	{
+		std::cerr << "Erro: mapa binário truncado" << std::endl;
+		return false;
+	}
+
+	mapa.tilesetFile.assign(p, tamNome);
+	p += tamNome;
+
+	mapa.props.resize(nProps);
+	for (uint32_t k = 0; k < nProps; k++, p += 3)
+		mapa.props[k] = {p[0] != 0, p[1] != 0, p[2] != 0};
+
+	mapa.tiles.resize(nCelulas);
+	memcpy(mapa.tiles.data(), p, nCelulas * sizeof(uint16_t));
+	for (uint16_t id : mapa.tiles)
+		if (id >= mapa.nTiles)
+		{
+			std::cerr << "Erro: tile " << id << " fora do tileset (" << mapa.nTiles << " tiles)" << std::endl;
+			return false;
+		}
+	return true;
+}
+
+} // namespace mapa_detalhe
+
+// Carrega um mapa em qualquer um dos formatos (detectado pelo "PGMB" no início)
+inline bool carregarMapa(const std::string &arquivo, MapaIso &mapa)
+{
+	std::vector<char> conteudo;
+	if (!mapa_detalhe::lerArquivo(arquivo, conteudo))
+	{
+		std::cerr << "Erro ao abrir arquivo de configuração: " << arquivo << std::endl;
+		return false;
+	}
+
+	bool ok;
+	if (conteudo.size() > 4 && memcmp(conteudo.data(), "PGMB", 4) == 0)
+		ok = mapa_detalhe::carregarMapaBinario(conteudo, mapa);
+	else
+		ok = mapa_detalhe::carregarMapaTexto(conteudo, mapa);
+
+	if (!ok)
+		return false;
+
+	for (uint16_t id : mapa.tiles)
+	{
+		if (id >= mapa.props.size())
+		{
+			std::cerr << "Erro: tile " << id << " sem propriedades em TileProperties" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+inline bool salvarMapaTexto(const std::string &arquivo, const MapaIso &mapa)
+{
+	FILE *f = fopen(arquivo.c_str(), "wb");
+	if (!f)
+		return false;
+
+	fprintf(f, "%s %d %d %d\n%d %d\n", mapa.tilesetFile.c_str(), mapa.nTiles, mapa.tileWidth, mapa.tileHeight,
+			mapa.largura, mapa.altura);
+
+	// Escreve linha a linha em um buffer próprio: fprintf por célula é lento demais
+	// para mapas de milhões de tiles
+	std::string linha;
+	linha.reserve((size_t)mapa.largura * 6);
+	char num[8];
+	for (int i = 0; i < mapa.altura; i++)
+	{
+		linha.clear();
+		for (int j = 0; j < mapa.largura; j++)
+		{
+			int n = snprintf(num, sizeof(num), j + 1 < mapa.largura ? "%u " : "%u", (unsigned)mapa.at(i, j));
+			linha.append(num, n);
+		}
+		linha.push_back('\n');
+		fwrite(linha.data(), 1, linha.size(), f);
+	}
+
+	fprintf(f, "--\nTileProperties\n");
+	for (const TileProperties &p : mapa.props)
+		fprintf(f, "%d %d %d\n", p.isChangeTile ? 1 : 0, p.isHazard ? 1 : 0, p.isCollectible ? 1 : 0);
+	fprintf(f, "<changeTile> <hazard> <collectible>");
+
+	fclose(f);
+	return true;
+}
+
+inline bool salvarMapaBinario(const std::string &arquivo, const MapaIso &mapa)
+{
+	FILE *f = fopen(arquivo.c_str(), "wb");
+	if (!f)
+		return false;
+
+	uint32_t cab[9] = {0, 1, (uint32_t)mapa.largura, (uint32_t)mapa.altura, (uint32_t)mapa.nTiles,
+					   (uint32_t)mapa.tileWidth, (uint32_t)mapa.tileHeight, (uint32_t)mapa.props.size(),
+					   (uint32_t)mapa.tilesetFile.size()};
+	memcpy(&cab[0], "PGMB", 4);
+	fwrite(cab, sizeof(cab), 1, f);
+	fwrite(mapa.tilesetFile.data(), 1, mapa.tilesetFile.size(), f);
+	for (const TileProperties &p : mapa.props)
+	{
+		char b[3] = {p.isChangeTile, p.isHazard, p.isCollectible};
+		fwrite(b, 1, 3, f);
+	}
+	fwrite(mapa.tiles.data(), sizeof(uint16_t), mapa.tiles.size(), f);
+
+	fclose(f);
+	return true;
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <Shader.h>
+
+// Picking (descobrir o que está sob o cursor) em O(1) por clique:
+//
+// - Grades: a célula sai direto da posição, por aritmética (pickGrade e
+//   pickIsometrico), sem percorrer nada.
+// - Formas arbitrárias: PickingIdBuffer desenha cada forma com o seu ID em uma
+//   textura R32UI fora da tela e lê de volta só o pixel do clique, por um PBO e uma
+//   fence, sem bloquear a CPU esperando a GPU.
+
+// Grade retangular de linhas x colunas células de larguraCelula x alturaCelula a
+// partir de (0, 0). Retorna false se o ponto cai fora da grade.
+inline bool pickGrade(double x, double y, float larguraCelula, float alturaCelula, int linhas, int colunas, int &i, int &j)
+{
+	if (x < 0.0 || y < 0.0)
+		return false;
+	i = (int)(y / alturaCelula);
+	j = (int)(x / larguraCelula);
+	return i < linhas && j < colunas;
+}
+
+// Inversa da projeção isométrica em losango: o tile [i][j] é desenhado em um quad de
+// tamTile com canto em origem + ((j - i) * w/2, (j + i) * h/2). Em unidades de meio
+// tile relativas ao centro do tile [0][0], o centro de [i][j] fica em (j - i, j + i);
+// girando de volta e arredondando cada eixo obtém-se exatamente o losango que contém
+// o ponto (a mesma conta do shader do mapa do GrauB).
+inline bool pickIsometrico(glm::vec2 mundo, glm::vec2 origem, glm::vec2 tamTile, int linhas, int colunas, int &i, int &j)
+{
+	glm::vec2 p = (mundo - origem) / (tamTile * 0.5f) - glm::vec2(1.0f);
+	j = (int)std::floor((p.x + p.y) * 0.5f + 0.5f);
+	i = (int)std::floor((p.y - p.x) * 0.5f + 0.5f);
+	return i >= 0 && j >= 0 && i < linhas && j < colunas;
+}
+
+// Buffer de IDs para picking de formas quaisquer. Uso, no frame do clique:
+//
+//   ids.begin(projection);
+//   ids.desenhar(vao, GL_TRIANGLES, 0, 3, model, indice + 1);   // para cada forma
+//   ids.end(xClique, yClique);
+//
+// ou, com todas as formas num só buffer e do mesmo número de vértices, numa chamada:
+//
+//   ids.begin(projection);
+//   ids.idPorVertice(3, model);   // id = gl_VertexID / 3 + 1
+//   pool.desenhar(GL_TRIANGLES);
+//   ids.end(xClique, yClique);
+//
+// e nos frames seguintes, até chegar o resultado:
+//
+//   uint32_t id;
+//   if (ids.pendente() && ids.resultado(id)) ...   // id 0 = nada sob o cursor
+class PickingIdBuffer {
+public:
+	bool init(int largura, int altura)
+	{
+		programa = compilar();
+		if (!programa)
+			return false;
+		projLoc = glGetUniformLocation(programa, "projection");
+		modelLoc = glGetUniformLocation(programa, "model");
+		idLoc = glGetUniformLocation(programa, "id");
+		verticesPorIdLoc = glGetUniformLocation(programa, "verticesPorId");
+
+		glGenFramebuffers(1, &fbo);
+		glGenTextures(1, &texID);
+		glGenBuffers(1, &pbo);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(uint32_t), nullptr, GL_STREAM_READ);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		return redimensionar(largura, altura);
+	}
+
+	// Deve acompanhar o tamanho do framebuffer da janela
+	bool redimensionar(int largura, int altura)
+	{
+		this->largura = largura;
+		this->altura = altura;
+
+		glBindTexture(GL_TEXTURE_2D, texID);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, largura, altura, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texID, 0);
+		bool completo = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		if (!completo)
+			std::cout << "ERROR::PICKING::FRAMEBUFFER_INCOMPLETE" << std::endl;
+		return completo;
+	}
+
+	void begin(const glm::mat4 &projection)
+	{
+		glGetIntegerv(GL_VIEWPORT, viewportAnterior);
+		glGetIntegerv(GL_CURRENT_PROGRAM, &programaAnterior);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glViewport(0, 0, largura, altura);
+		const GLuint zero[4] = {0, 0, 0, 0};
+		glClearBufferuiv(GL_COLOR, 0, zero);
+
+		glUseProgram(programa);
+		glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+		glUniform1i(verticesPorIdLoc, verticesPorId = 0);
+	}
+
+	void desenhar(GLuint vao, GLenum modo, GLint primeiro, GLsizei n, const glm::mat4 &model, uint32_t id)
+	{
+		if (verticesPorId != 0)
+			glUniform1i(verticesPorIdLoc, verticesPorId = 0);
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		glUniform1ui(idLoc, id);
+		glBindVertexArray(vao);
+		glDrawArrays(modo, primeiro, n);
+	}
+
+	// Os próximos desenhos (feitos pelo chamador, até o end) tiram o ID do próprio
+	// vértice: gl_VertexID / verticesPorId + 1. Com formas de verticesPorId vértices
+	// em blocos alinhados de um buffer, o ID é o bloco da forma + 1, e todas saem numa
+	// chamada (glMultiDrawArrays inclusive: o gl_VertexID conta a partir do first).
+	void idPorVertice(int n, const glm::mat4 &model)
+	{
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+		glUniform1i(verticesPorIdLoc, verticesPorId = n);
+	}
+
+	// Agenda a leitura do pixel (x, y) em coordenadas do framebuffer (origem embaixo,
+	// à esquerda) e volta para o framebuffer, viewport e programa de antes do begin().
+	// Um pedido anterior ainda não lido é descartado.
+	void end(int x, int y)
+	{
+		glBindVertexArray(0);
+
+		if (fence)
+			glDeleteSync(fence);
+		fence = nullptr;
+
+		if (x >= 0 && y >= 0 && x < largura && y < altura)
+		{
+			glReadBuffer(GL_COLOR_ATTACHMENT0);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+			glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, (void *)0);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		else
+			foraDaTela = true;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(viewportAnterior[0], viewportAnterior[1], viewportAnterior[2], viewportAnterior[3]);
+		glUseProgram(programaAnterior);
+	}
+
+	bool pendente() const { return fence != nullptr || foraDaTela; }
+
+	// Não bloqueia: retorna false enquanto a GPU não terminou a leitura
+	bool resultado(uint32_t &id)
+	{
+		if (foraDaTela)
+		{
+			foraDaTela = false;
+			id = 0;
+			return true;
+		}
+		if (!fence)
+			return false;
+
+		GLenum estado = glClientWaitSync(fence, 0, 0);
+		if (estado != GL_ALREADY_SIGNALED && estado != GL_CONDITION_SATISFIED)
+			return false;
+		glDeleteSync(fence);
+		fence = nullptr;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+		const uint32_t *dado = (const uint32_t *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(uint32_t), GL_MAP_READ_BIT);
+		id = dado ? *dado : 0;
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		return true;
+	}
+
+private:
+	GLuint compilar()
+	{
+		const GLchar *vs = R"(
+#version 400
+layout (location = 0) in vec3 position;
+uniform mat4 projection;
+uniform mat4 model;
+uniform uint id;
+uniform int verticesPorId; // 0: o ID é o uniform
+flat out uint idForma;
+void main()
+{
+	idForma = verticesPorId > 0 ? uint(gl_VertexID / verticesPorId + 1) : id;
+	gl_Position = projection * model * vec4(position, 1.0);
+}
+)";
+		const GLchar *fs = R"(
+#version 400
+flat in uint idForma;
+out uint fragId;
+void main()
+{
+	fragId = idForma;
+}
+)";
+		// setupShader mostra os logs de compilação e de link
+		return setupShader(vs, fs);
+	}
+
+	GLuint programa = 0, fbo = 0, texID = 0, pbo = 0;
+	GLint projLoc = -1, modelLoc = -1, idLoc = -1, verticesPorIdLoc = -1;
+	int verticesPorId = 0;
+	GLint viewportAnterior[4] = {0, 0, 0, 0};
+	GLint programaAnterior = 0;
+	GLsync fence = nullptr;
+	bool foraDaTela = false;
+	int largura = 0, altura = 0;
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Vértice com posição e cor: com a cor no próprio vértice, formas de cores
+// diferentes saem na mesma chamada de desenho
+struct VerticeCor {
+	float x, y, z;
+	float r, g, b;
+};
+
+// Um único VBO (e um único VAO) compartilhado por todas as formas criadas em tempo
+// de execução. Cada forma ocupa um bloco contíguo de vértices, obtido de uma lista
+// livre (first-fit, com fusão de blocos vizinhos ao liberar); quando não há espaço
+// o buffer dobra de tamanho e o conteúdo é copiado na GPU (glCopyBufferSubData).
+// O número de objetos GL é constante, não importa quantas formas existam.
+//
+// Layout do VAO: location 0 = posição (vec3), location 1 = cor (vec3).
+//
+//   int forma = pool.alocar(vertices, 3);
+//   pool.desenhar(GL_TRIANGLES);          // todas as formas vivas, um glMultiDrawArrays
+//   pool.liberar(forma);
+class PoolVertices {
+public:
+	void init(int capacidadeInicial = 1024)
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		capacidade = std::max(1, capacidadeInicial);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacidade * sizeof(VerticeCor), nullptr, GL_DYNAMIC_DRAW);
+		configurarVAO();
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		livres.push_back({0, capacidade});
+	}
+
+	// Copia n vértices para um bloco novo e retorna o identificador da forma
+	int alocar(const VerticeCor *vertices, int n)
+	{
+		int inicio = reservar(n);
+		if (inicio < 0)
+		{
+			crescer(n);
+			inicio = reservar(n);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)inicio * sizeof(VerticeCor), (GLsizeiptr)n * sizeof(VerticeCor), vertices);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		int id;
+		if (!idsLivres.empty())
+		{
+			id = idsLivres.back();
+			idsLivres.pop_back();
+			formas[id] = {inicio, n, true};
+		}
+		else
+		{
+			id = (int)formas.size();
+			formas.push_back({inicio, n, true});
+		}
+		encadear(id);
+		listaDesenhoValida = false;
+		return id;
+	}
+
+	// Aloca nFormas formas de n vértices cada, contíguas no buffer, com um único envio.
+	// vertices pode apontar direto para um arquivo mapeado em memória.
+	void alocarLote(const VerticeCor *vertices, int nFormas, int n, std::vector<int> &ids)
+	{
+		int total = nFormas * n;
+		int inicio = reservar(total);
+		if (inicio < 0)
+		{
+			crescer(total);
+			inicio = reservar(total);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)inicio * sizeof(VerticeCor), (GLsizeiptr)total * sizeof(VerticeCor), vertices);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		ids.resize(nFormas);
+		formas.reserve(formas.size() + nFormas);
+		for (int k = 0; k < nFormas; k++)
+		{
+			ids[k] = (int)formas.size();
+			formas.push_back({inicio + k * n, n, true});
+			encadear(ids[k]);
+		}
+		listaDesenhoValida = false;
+	}
+
+	// Libera todas as formas (a capacidade do buffer é mantida)
+	void limpar()
+	{
+		formas.clear();
+		idsLivres.clear();
+		primeiraForma = ultimaForma = -1;
+		livres.assign(1, {0, capacidade});
+		listaDesenhoValida = false;
+	}
+
+	// Reescreve os vértices de uma forma (mesma quantidade da alocação)
+	void atualizar(int id, const VerticeCor *vertices)
+	{
+		const Forma &f = formas[id];
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)f.inicio * sizeof(VerticeCor), (GLsizeiptr)f.n * sizeof(VerticeCor), vertices);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void liberar(int id)
+	{
+		Forma &f = formas[id];
+		if (!f.viva)
+			return;
+		f.viva = false;
+		idsLivres.push_back(id);
+		desencadear(id);
+		devolver({f.inicio, f.n});
+		listaDesenhoValida = false;
+	}
+
+	// Desenha todas as formas vivas com uma chamada, na ordem em que foram criadas
+	void desenhar(GLenum modo)
+	{
+		if (!listaDesenhoValida)
+			montarListaDesenho();
+		if (primeiros.empty())
+			return;
+		glBindVertexArray(VAO);
+		glMultiDrawArrays(modo, primeiros.data(), contagens.data(), (GLsizei)primeiros.size());
+		glBindVertexArray(0);
+	}
+
+	// Primeiro vértice e quantidade de vértices de uma forma (para desenhá-la sozinha)
+	GLint primeiro(int id) const { return formas[id].inicio; }
+	GLsizei quantidade(int id) const { return formas[id].n; }
+
+	GLuint vao() const { return VAO; }
+
+	// Lê o conteúdo inteiro do buffer de volta (indexado por primeiro(id)), para salvar
+	void copiarParaCPU(std::vector<VerticeCor> &destino) const
+	{
+		destino.resize(capacidade);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glGetBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)capacidade * sizeof(VerticeCor), destino.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	int capacidadeVertices() const { return capacidade; }
+
+private:
+	struct Forma {
+		int inicio, n;
+		bool viva;
+		int anterior, proximo; // vizinhas na ordem de criação (-1 nas pontas)
+	};
+	struct Bloco {
+		int inicio, n;
+	};
+
+	// A ordem de criação é uma lista duplamente encadeada dentro de formas: liberar
+	// uma forma não percorre as outras
+	void encadear(int id)
+	{
+		formas[id].anterior = ultimaForma;
+		formas[id].proximo = -1;
+		if (ultimaForma >= 0)
+			formas[ultimaForma].proximo = id;
+		else
+			primeiraForma = id;
+		ultimaForma = id;
+	}
+
+	void desencadear(int id)
+	{
+		Forma &f = formas[id];
+		if (f.anterior >= 0)
+			formas[f.anterior].proximo = f.proximo;
+		else
+			primeiraForma = f.proximo;
+		if (f.proximo >= 0)
+			formas[f.proximo].anterior = f.anterior;
+		else
+			ultimaForma = f.anterior;
+	}
+
+	void configurarVAO()
+	{
+		glBindVertexArray(VAO);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VerticeCor), (GLvoid *)offsetof(VerticeCor, x));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VerticeCor), (GLvoid *)offsetof(VerticeCor, r));
+		glEnableVertexAttribArray(1);
+		glBindVertexArray(0);
+	}
+
+	// First-fit na lista livre (ordenada por início); -1 se nenhum bloco comporta n
+	int reservar(int n)
+	{
+		for (size_t k = 0; k < livres.size(); k++)
+		{
+			if (livres[k].n >= n)
+			{
+				int inicio = livres[k].inicio;
+				livres[k].inicio += n;
+				livres[k].n -= n;
+				if (livres[k].n == 0)
+					livres.erase(livres.begin() + k);
+				return inicio;
+			}
+		}
+		return -1;
+	}
+
+	// Devolve um bloco à lista livre, fundindo com os vizinhos
+	void devolver(Bloco b)
+	{
+		size_t k = 0;
+		while (k < livres.size() && livres[k].inicio < b.inicio)
+			k++;
+		livres.insert(livres.begin() + k, b);
+
+		if (k + 1 < livres.size() && livres[k].inicio + livres[k].n == livres[k + 1].inicio)
+		{
+			livres[k].n += livres[k + 1].n;
+			livres.erase(livres.begin() + k + 1);
+		}
+		if (k > 0 && livres[k - 1].inicio + livres[k - 1].n == livres[k].inicio)
+		{
+			livres[k - 1].n += livres[k].n;
+			livres.erase(livres.begin() + k);
+		}
+	}
+
+	// Dobra a capacidade até caber mais n vértices; o VBO novo substitui o antigo
+	void crescer(int n)
+	{
+		int antiga = capacidade;
+		while (capacidade - antiga < n)
+			capacidade *= 2;
+
+		GLuint novo;
+		glGenBuffers(1, &novo);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, novo);
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacidade * sizeof(VerticeCor), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)antiga * sizeof(VerticeCor));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &VBO);
+		VBO = novo;
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		configurarVAO();
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		devolver({antiga, capacidade - antiga});
+	}
+
+	void montarListaDesenho()
+	{
+		primeiros.clear();
+		contagens.clear();
+		for (int id = primeiraForma; id >= 0; id = formas[id].proximo)
+		{
+			primeiros.push_back(formas[id].inicio);
+			contagens.push_back(formas[id].n);
+		}
+		listaDesenhoValida = true;
+	}
+
+	GLuint VAO = 0, VBO = 0;
+	int capacidade = 0;
+	std::vector<Bloco> livres;
+	std::vector<Forma> formas;
+	std::vector<int> idsLivres;
+	int primeiraForma = -1, ultimaForma = -1; // formas vivas, na ordem de criação
+	std::vector<GLint> primeiros;
+	std::vector<GLsizei> contagens;
+	bool listaDesenhoValida = false;
+};
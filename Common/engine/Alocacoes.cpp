@@ -0,0 +1,108 @@
+#include "Alocacoes.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Substituição do operator new/delete globais. Fica na biblioteca da engine: como
+// todo programa usa operator new, o linker sempre traz este arquivo junto.
+
+static std::atomic<uint64_t> totalAlocacoes{0};
+static std::atomic<uint64_t> totalBytes{0};
+
+ContagemAlocacoes contagemAlocacoes()
+{
+	ContagemAlocacoes c;
+	c.alocacoes = totalAlocacoes.load(std::memory_order_relaxed);
+	c.bytes = totalBytes.load(std::memory_order_relaxed);
+	return c;
+}
+
+static void *alocarContando(std::size_t bytes)
+{
+	totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+	totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+	return std::malloc(bytes ? bytes : 1);
+}
+
+static void *alocarAlinhadoContando(std::size_t bytes, std::size_t alinhamento)
+{
+	totalAlocacoes.fetch_add(1, std::memory_order_relaxed);
+	totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+	if (!bytes)
+		bytes = 1;
+#ifdef _WIN32
+	return _aligned_malloc(bytes, alinhamento);
+#else
+	void *p = nullptr;
+	return posix_memalign(&p, alinhamento < sizeof(void *) ? sizeof(void *) : alinhamento, bytes) == 0 ? p : nullptr;
+#endif
+}
+
+static void liberarAlinhado(void *p)
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+void *operator new(std::size_t bytes)
+{
+	if (void *p = alocarContando(bytes))
+		return p;
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t bytes)
+{
+	if (void *p = alocarContando(bytes))
+		return p;
+	throw std::bad_alloc();
+}
+
+void *operator new(std::size_t bytes, const std::nothrow_t &) noexcept { return alocarContando(bytes); }
+void *operator new[](std::size_t bytes, const std::nothrow_t &) noexcept { return alocarContando(bytes); }
+
+void *operator new(std::size_t bytes, std::align_val_t alinhamento)
+{
+	if (void *p = alocarAlinhadoContando(bytes, (std::size_t)alinhamento))
+		return p;
+	throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alinhamento)
+{
+	if (void *p = alocarAlinhadoContando(bytes, (std::size_t)alinhamento))
+		return p;
+	throw std::bad_alloc();
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alinhamento, const std::nothrow_t &) noexcept
+{
+	return alocarAlinhadoContando(bytes, (std::size_t)alinhamento);
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alinhamento, const std::nothrow_t &) noexcept
+{
+	return alocarAlinhadoContando(bytes, (std::size_t)alinhamento);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept { liberarAlinhado(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { liberarAlinhado(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { liberarAlinhado(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { liberarAlinhado(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { liberarAlinhado(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { liberarAlinhado(p); }
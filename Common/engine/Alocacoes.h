@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Contagem das alocações no heap feitas com new/new[] (inclusive as dos contêineres
+// da biblioteca padrão): a engine substitui o operator new global por um que soma
+// num contador atômico e chama malloc. malloc direto (GLFW, stb_image, driver) não
+// entra na conta.
+//
+// Para medir um trecho, a diferença entre duas leituras:
+//
+//   ContagemAlocacoes antes = contagemAlocacoes();
+//   ...                                   // um frame
+//   uint64_t n = contagemAlocacoes().alocacoes - antes.alocacoes;
+struct ContagemAlocacoes {
+	uint64_t alocacoes = 0;
+	uint64_t bytes = 0;
+};
+
+// Total desde o início do programa, somando todas as threads
+ContagemAlocacoes contagemAlocacoes();
@@ -0,0 +1,48 @@
+#include "ArenaFrame.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// Primeiro endereço alinhado a partir de p
+static unsigned char *alinhar(unsigned char *p, size_t alinhamento)
+{
+	uintptr_t v = reinterpret_cast<uintptr_t>(p);
+	return p + ((alinhamento - v % alinhamento) % alinhamento);
+}
+
+ArenaFrame::ArenaFrame(size_t capacidade)
+	: bloco(new unsigned char[capacidade]), tamanho(capacidade)
+{
+}
+
+void *ArenaFrame::alocar(size_t bytes, size_t alinhamento)
+{
+	unsigned char *inicio = alinhar(bloco.get() + topo, alinhamento);
+	size_t fim = (size_t)(inicio - bloco.get()) + bytes;
+	if (fim <= tamanho)
+	{
+		topo = fim;
+		picoUso = std::max(picoUso, usado());
+		return inicio;
+	}
+
+	// Não coube: bloco extra só para este pedido, até o próximo reiniciar()
+	size_t tamanhoExtra = bytes + alinhamento;
+	extras.emplace_back(new unsigned char[tamanhoExtra]);
+	usadoExtras += tamanhoExtra;
+	picoUso = std::max(picoUso, usado());
+	return alinhar(extras.back().get(), alinhamento);
+}
+
+void ArenaFrame::reiniciar()
+{
+	if (!extras.empty())
+	{
+		// O frame passou da capacidade: o bloco principal passa a caber o pico
+		tamanho = std::max(tamanho * 2, picoUso + picoUso / 4);
+		bloco.reset(new unsigned char[tamanho]);
+		extras.clear();
+		usadoExtras = 0;
+	}
+	topo = 0;
+}
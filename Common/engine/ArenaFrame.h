@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Alocador linear para o que só vive durante um frame (comandos de desenho, listas
+// de tiles visíveis, vértices temporários): alocar() só avança um ponteiro e
+// reiniciar(), no começo de cada frame, devolve tudo de uma vez. Nada é destruído,
+// então só servem tipos trivialmente destrutíveis.
+//
+// Um frame que passe da capacidade pega o excesso em blocos extras do heap; no
+// reiniciar() seguinte o bloco principal cresce até o pico visto. Depois de poucos
+// frames o tamanho estabiliza e os frames deixam de alocar.
+//
+//   ArenaFrame arena;
+//   ...
+//   arena.reiniciar();                                    // começo do frame
+//   QuadTexturizado *quads = arena.alocarArray<QuadTexturizado>(n);
+class ArenaFrame {
+public:
+	explicit ArenaFrame(size_t capacidade = 256 * 1024);
+	ArenaFrame(const ArenaFrame &) = delete;
+	ArenaFrame &operator=(const ArenaFrame &) = delete;
+
+	void *alocar(size_t bytes, size_t alinhamento = alignof(std::max_align_t));
+
+	// n objetos construídos com T()
+	template <typename T>
+	T *alocarArray(size_t n)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "a arena não chama destrutores");
+		T *p = static_cast<T *>(alocar(n * sizeof(T), alignof(T)));
+		for (size_t k = 0; k < n; k++)
+			new (p + k) T();
+		return p;
+	}
+
+	void reiniciar();
+
+	size_t usado() const { return topo + usadoExtras; }
+	size_t capacidade() const { return tamanho; }
+	size_t pico() const { return picoUso; }
+
+private:
+	std::unique_ptr<unsigned char[]> bloco;
+	size_t tamanho = 0, topo = 0;
+	std::vector<std::unique_ptr<unsigned char[]>> extras;
+	size_t usadoExtras = 0;
+	size_t picoUso = 0;
+};
@@ -0,0 +1,189 @@
+#include "BufferStreaming.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+bool BufferStreaming::init(size_t bytesPorRegiao, int regioes, bool permitirPersistente)
+{
+	nRegioes = std::clamp(regioes, 2, MAX_REGIOES);
+	bytesRegiao = std::max<size_t>(bytesPorRegiao, 256);
+	usarPersistente = permitirPersistente;
+	criar();
+	return id != 0;
+}
+
+void BufferStreaming::criar()
+{
+	size_t total = bytesRegiao * nRegioes;
+	glGenBuffers(1, &id);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+
+	mapeadoSempre = false;
+	mapa = nullptr;
+	if (usarPersistente && (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage))
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)total, nullptr, flags);
+		mapa = (unsigned char *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)total, flags);
+		mapeadoSempre = mapa != nullptr;
+	}
+	if (!mapeadoSempre)
+	{
+		// Buffer imutável que não pôde ser mapeado: troca por um comum
+		if (usarPersistente && (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage))
+		{
+			glDeleteBuffers(1, &id);
+			glGenBuffers(1, &id);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+		}
+		glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)total, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	atual = 0;
+	ultimaEscrita = -1;
+	topo = 0;
+	nGeracao++;
+}
+
+void BufferStreaming::destruir()
+{
+	if (!id)
+		return;
+	if (mapeadoSempre)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	for (GLsync &f : fences)
+	{
+		if (f)
+			glDeleteSync(f);
+		f = nullptr;
+	}
+	glDeleteBuffers(1, &id);
+	id = 0;
+	mapa = nullptr;
+	mapeadoSempre = false;
+}
+
+// Espera a GPU terminar os frames que leram a região
+void BufferStreaming::esperar(int regiao)
+{
+	GLsync &f = fences[regiao];
+	if (!f)
+		return;
+
+	GLenum estado = glClientWaitSync(f, 0, 0);
+	if (estado != GL_ALREADY_SIGNALED && estado != GL_CONDITION_SATISFIED)
+	{
+		auto inicio = std::chrono::steady_clock::now();
+		do
+			estado = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+		while (estado == GL_TIMEOUT_EXPIRED);
+		double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+		frame.esperas++;
+		frame.segundosEsperando += segundos;
+		acumulado.esperas++;
+		acumulado.segundosEsperando += segundos;
+	}
+	glDeleteSync(f);
+	f = nullptr;
+}
+
+// O frame não coube na região: buffer novo com regiões maiores. O antigo só é
+// liberado pelo driver quando a GPU terminar de usá-lo, então não há espera. O
+// tamanho da região é múltiplo do alinhamento pedido, para o início de todas as
+// regiões continuar alinhado.
+void BufferStreaming::crescer(size_t bytesNoFrame, size_t alinhamento)
+{
+	size_t novo = std::max(bytesRegiao * 2, bytesNoFrame + bytesNoFrame / 4);
+	novo = (novo + alinhamento - 1) / alinhamento * alinhamento;
+	destruir();
+	bytesRegiao = novo;
+	criar();
+
+	frame.realocacoes++;
+	acumulado.realocacoes++;
+}
+
+void *BufferStreaming::reservar(size_t bytes, GLintptr &deslocamento, size_t alinhamento)
+{
+	if (!escreveuNoFrame)
+	{
+		esperar(atual);
+		topo = 0;
+		escreveuNoFrame = true;
+	}
+
+	// Alinhado no buffer, não só na região: quem lê por índice (texture buffer com
+	// registros de 48 bytes, por exemplo) divide o deslocamento pelo tamanho
+	size_t base = atual * bytesRegiao;
+	size_t inicio = (base + topo + alinhamento - 1) / alinhamento * alinhamento - base;
+	if (inicio + bytes > bytesRegiao)
+	{
+		crescer(inicio + bytes, alinhamento);
+		base = atual * bytesRegiao;
+		inicio = (base + alinhamento - 1) / alinhamento * alinhamento - base;
+	}
+	topo = inicio + bytes;
+	deslocamento = (GLintptr)(atual * bytesRegiao + inicio);
+
+	frame.bytes += bytes;
+	frame.reservas++;
+	acumulado.bytes += bytes;
+	acumulado.reservas++;
+
+	if (mapeadoSempre)
+		return mapa + deslocamento;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+	void *p = glMapBufferRange(GL_COPY_WRITE_BUFFER, deslocamento, (GLsizeiptr)bytes,
+							   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	mapeadaAgora = true;
+	return p;
+}
+
+void BufferStreaming::confirmar()
+{
+	if (!mapeadaAgora)
+		return;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	mapeadaAgora = false;
+}
+
+void BufferStreaming::fimDoFrame()
+{
+	// A fence vai na região que o frame pode ter lido: a escrita agora ou, num frame
+	// sem escrita, a dos dados que continuam sendo desenhados
+	int cercar = escreveuNoFrame ? atual : ultimaEscrita;
+	if (cercar >= 0)
+	{
+		if (fences[cercar])
+			glDeleteSync(fences[cercar]);
+		fences[cercar] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	if (escreveuNoFrame)
+	{
+		ultimaEscrita = atual;
+		atual = (atual + 1) % nRegioes;
+		escreveuNoFrame = false;
+	}
+
+	ultimo = frame;
+	frame = EstatisticasStreaming();
+}
+
+void BufferStreaming::relatorio(std::ostream &saida) const
+{
+	saida << "Streaming (" << (mapeadoSempre ? "mapeamento persistente" : "mapeamento por reserva") << ", "
+		  << nRegioes << " regiões de " << bytesRegiao / 1024.0 << " KB): "
+		  << acumulado.bytes / (1024.0 * 1024.0) << " MB em " << acumulado.reservas << " reservas, "
+		  << acumulado.esperas << " esperas pela GPU (" << acumulado.segundosEsperando * 1000.0 << " ms), "
+		  << acumulado.realocacoes << " realocações\n";
+}
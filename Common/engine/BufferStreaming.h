@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include <glad/glad.h>
+
+// Buffer para dados que mudam todo frame (instâncias, vértices de formas, tiles
+// alterados) sem glBufferData a cada envio. O buffer é dividido em regiões (3 por
+// padrão) usadas em rodízio: a CPU escreve numa região enquanto a GPU ainda lê as
+// dos frames anteriores, e cada região tem um glFenceSync que diz quando a GPU a
+// largou. Só há espera quando a CPU dá a volta e alcança a GPU.
+//
+// Com OpenGL 4.4 (ou GL_ARB_buffer_storage) o buffer fica mapeado o tempo todo
+// (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT) e reservar() só devolve um ponteiro.
+// Sem isso, cada reserva mapeia a faixa com GL_MAP_UNSYNCHRONIZED_BIT (as fences
+// fazem a sincronização) e confirmar() desmapeia.
+//
+//   stream.init(64 * 1024);
+//   ...
+//   GLintptr deslocamento;
+//   Instancia *dst = (Instancia *)stream.reservar(n * sizeof(Instancia), deslocamento);
+//   ...                                  // escreve as n instâncias
+//   stream.confirmar();
+//   glVertexAttribPointer(..., (GLvoid *)deslocamento);
+//   glDrawArraysInstanced(...);
+//   ...
+//   glfwSwapBuffers(window);
+//   stream.fimDoFrame();
+//
+// O que foi escrito continua válido (pode ser desenhado de novo) até a próxima
+// reserva feita num frame seguinte. O ponteiro de reservar() vale até confirmar().
+// Um frame que passe do tamanho da região faz o buffer ser recriado com o dobro;
+// os atributos precisam ser apontados de novo (a cada desenho, com o deslocamento,
+// já ficam) e um texture buffer, religado com glTexBuffer. Para saber quando, use
+// geracao(): o driver pode devolver o mesmo nome para o buffer novo, então comparar
+// buffer() não basta.
+struct EstatisticasStreaming {
+	uint64_t bytes = 0;             // escritos nas reservas
+	uint32_t reservas = 0;
+	uint32_t esperas = 0;           // reservas que tiveram de esperar a GPU
+	double segundosEsperando = 0.0;
+	uint32_t realocacoes = 0;       // buffer recriado por falta de espaço
+};
+
+class BufferStreaming {
+public:
+	BufferStreaming() = default;
+	BufferStreaming(const BufferStreaming &) = delete;
+	BufferStreaming &operator=(const BufferStreaming &) = delete;
+
+	// bytesPorRegiao: o máximo esperado por frame. permitirPersistente = false força
+	// o mapeamento por reserva (para comparar os dois caminhos). O buffer pode ser
+	// ligado em qualquer alvo; as operações internas usam GL_COPY_WRITE_BUFFER.
+	bool init(size_t bytesPorRegiao, int regioes = 3, bool permitirPersistente = true);
+	// Com o contexto ainda ativo (não há destrutor que chame a OpenGL)
+	void destruir();
+
+	// Espaço para bytes (> 0) na região do frame; deslocamento é a posição no buffer
+	void *reservar(size_t bytes, GLintptr &deslocamento, size_t alinhamento = 16);
+	void confirmar();
+
+	// Depois do último desenho do frame (ou do glfwSwapBuffers)
+	void fimDoFrame();
+
+	GLuint buffer() const { return id; }
+	// Muda a cada vez que o armazenamento é recriado (começa em 1 depois do init)
+	uint32_t geracao() const { return nGeracao; }
+	bool persistente() const { return mapeadoSempre; }
+	size_t tamanhoRegiao() const { return bytesRegiao; }
+
+	// Do último frame fechado e acumulado desde o init
+	const EstatisticasStreaming &ultimoFrame() const { return ultimo; }
+	const EstatisticasStreaming &total() const { return acumulado; }
+	void relatorio(std::ostream &saida) const;
+
+private:
+	static constexpr int MAX_REGIOES = 4;
+
+	void criar();
+	void esperar(int regiao);
+	void crescer(size_t bytesNoFrame, size_t alinhamento);
+
+	GLuint id = 0;
+	uint32_t nGeracao = 0;
+	int nRegioes = 3;
+	size_t bytesRegiao = 0;
+	bool usarPersistente = true, mapeadoSempre = false;
+	unsigned char *mapa = nullptr; // mapeamento persistente (do buffer inteiro)
+	GLsync fences[MAX_REGIOES] = {};
+
+	int atual = 0;              // região onde o frame escreve
+	int ultimaEscrita = -1;     // região com os dados mais recentes (ainda desenhados)
+	size_t topo = 0;            // bytes usados na região atual
+	bool escreveuNoFrame = false, mapeadaAgora = false;
+
+	EstatisticasStreaming frame, ultimo, acumulado;
+};
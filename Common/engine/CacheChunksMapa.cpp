@@ -0,0 +1,246 @@
+#include "CacheChunksMapa.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+// Quad unitário com t invertido: o sprite.vert usa 1 - t, e a linha 0 da textura
+// do framebuffer é o yMin do chunk
+const GLfloat verticesComposicao[] = {
+	// x   y    z    s    t
+	0.0, 0.0, 0.0, 0.0, 1.0,
+	0.0, 1.0, 0.0, 0.0, 0.0,
+	1.0, 0.0, 0.0, 1.0, 1.0,
+	1.0, 1.0, 0.0, 1.0, 0.0,
+};
+
+} // namespace
+
+bool CacheChunksMapa::init(int nChunks, size_t orcamento)
+{
+	orcamentoBytes = orcamento;
+	slotDoChunk.assign(std::max(0, nChunks), -1);
+
+	GLint maxTextura = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextura);
+	tamMaximo = std::min(TAM_MAX_TEXTURA, (int)maxTextura);
+
+	glGenFramebuffers(1, &fbo);
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(verticesComposicao), verticesComposicao, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return fbo != 0 && vao != 0;
+}
+
+void CacheChunksMapa::destruir()
+{
+	for (int s = 0; s < (int)slots.size(); s++)
+		liberar(s);
+	slots.clear();
+	if (fbo)
+		glDeleteFramebuffers(1, &fbo);
+	if (vbo)
+		glDeleteBuffers(1, &vbo);
+	if (vao)
+		glDeleteVertexArrays(1, &vao);
+	fbo = vbo = vao = 0;
+}
+
+GLuint CacheChunksMapa::textura(int chunk, float escala)
+{
+	int s = slotDoChunk[chunk];
+	if (s < 0)
+		return 0;
+
+	Entrada &e = slots[s];
+	e.ultimoUso = frame;
+	if (!e.valida || e.escala != escala)
+		return 0;
+
+	atual.acertos++;
+	acumulado.acertos++;
+	return e.textura;
+}
+
+void CacheChunksMapa::liberar(int s)
+{
+	Entrada &e = slots[s];
+	if (e.chunk < 0)
+		return;
+	glDeleteTextures(1, &e.textura);
+	usados -= (size_t)e.largura * e.altura * 4;
+	slotDoChunk[e.chunk] = -1;
+	e = Entrada();
+}
+
+// Descarta as texturas usadas há mais tempo (nunca as do frame atual) até bytes caberem
+bool CacheChunksMapa::abrirEspaco(size_t bytes)
+{
+	while (usados + bytes > orcamentoBytes)
+	{
+		int maisAntigo = -1;
+		for (int s = 0; s < (int)slots.size(); s++)
+		{
+			const Entrada &e = slots[s];
+			if (e.chunk >= 0 && e.ultimoUso < frame && (maisAntigo < 0 || e.ultimoUso < slots[maisAntigo].ultimoUso))
+				maisAntigo = s;
+		}
+		if (maisAntigo < 0)
+			return false;
+		liberar(maisAntigo);
+		atual.descartes++;
+		acumulado.descartes++;
+	}
+	return true;
+}
+
+bool CacheChunksMapa::comecar(int chunk, const glm::vec4 &limites, float escala, glm::mat4 &projecao)
+{
+	// Chunks muito grandes para o zoom ficam com menos texels por unidade do mundo
+	glm::vec2 tamanhoMundo(limites.z - limites.x, limites.w - limites.y);
+	float escalaTextura = std::min(escala, tamMaximo / std::max(tamanhoMundo.x, tamanhoMundo.y));
+	int largura = std::max(1, (int)std::ceil(tamanhoMundo.x * escalaTextura));
+	int altura = std::max(1, (int)std::ceil(tamanhoMundo.y * escalaTextura));
+
+	// Mesmo tamanho: redesenha na textura que já existe
+	int s = slotDoChunk[chunk];
+	if (s >= 0 && (slots[s].largura != largura || slots[s].altura != altura))
+	{
+		liberar(s);
+		s = -1;
+	}
+	if (s < 0)
+	{
+		size_t bytes = (size_t)largura * altura * 4;
+		if (!abrirEspaco(bytes))
+		{
+			atual.recusas++;
+			acumulado.recusas++;
+			return false;
+		}
+
+		auto livre = std::find_if(slots.begin(), slots.end(), [](const Entrada &e) { return e.chunk < 0; });
+		if (livre == slots.end())
+			livre = slots.insert(slots.end(), Entrada());
+		s = (int)(livre - slots.begin());
+
+		Entrada &e = slots[s];
+		e.chunk = chunk;
+		e.largura = largura;
+		e.altura = altura;
+		glGenTextures(1, &e.textura);
+		glBindTexture(GL_TEXTURE_2D, e.textura);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, largura, altura, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		usados += bytes;
+		slotDoChunk[chunk] = s;
+	}
+
+	Entrada &e = slots[s];
+	e.escala = escala;
+	e.limites = limites;
+	e.tamanho = glm::vec2(largura, altura) / escalaTextura;
+	e.ultimoUso = frame;
+
+	glGetIntegerv(GL_VIEWPORT, viewportAnterior);
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blendAnterior[0]);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blendAnterior[1]);
+	glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendAnterior[2]);
+	glGetIntegerv(GL_BLEND_DST_ALPHA, &blendAnterior[3]);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, e.textura, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "ERROR::CACHE_CHUNKS::FRAMEBUFFER_INCOMPLETE" << std::endl;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		liberar(s);
+		return false;
+	}
+	glViewport(0, 0, largura, altura);
+	const GLfloat transparente[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	glClearBufferfv(GL_COLOR, 0, transparente);
+
+	// Cor pré-multiplicada e alfa acumulado, para compor o chunk como se os tiles
+	// fossem desenhados direto na tela
+	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	projecao = glm::ortho(limites.x, limites.x + e.tamanho.x, limites.y, limites.y + e.tamanho.y, -1.0f, 1.0f);
+	emRenderizacao = s;
+
+	atual.renderizacoes++;
+	acumulado.renderizacoes++;
+	return true;
+}
+
+GLuint CacheChunksMapa::terminar()
+{
+	if (emRenderizacao < 0)
+		return 0;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(viewportAnterior[0], viewportAnterior[1], viewportAnterior[2], viewportAnterior[3]);
+	glBlendFuncSeparate(blendAnterior[0], blendAnterior[1], blendAnterior[2], blendAnterior[3]);
+
+	Entrada &e = slots[emRenderizacao];
+	e.valida = true;
+	emRenderizacao = -1;
+	return e.textura;
+}
+
+QuadTexturizado CacheChunksMapa::quad(int chunk) const
+{
+	const Entrada &e = slots[slotDoChunk[chunk]];
+
+	QuadTexturizado q;
+	q.vao = vao;
+	q.vertices = verticesComposicao;
+	q.textura = e.textura;
+	q.model = glm::translate(q.model, glm::vec3(e.limites.x, e.limites.y, 0.0f));
+	q.model = glm::scale(q.model, glm::vec3(e.tamanho, 1.0f));
+	return q;
+}
+
+void CacheChunksMapa::invalidar(int chunk)
+{
+	int s = slotDoChunk[chunk];
+	if (s >= 0)
+		slots[s].valida = false;
+}
+
+void CacheChunksMapa::fimDoFrame()
+{
+	frame++;
+	ultimo = atual;
+	atual = EstatisticasCacheChunks();
+}
+
+void CacheChunksMapa::relatorio(std::ostream &saida) const
+{
+	int residentes = 0;
+	for (const Entrada &e : slots)
+		residentes += e.chunk >= 0;
+
+	saida << "Cache de chunks: " << residentes << " texturas, " << usados / (1024.0 * 1024.0) << " de "
+		  << orcamentoBytes / (1024.0 * 1024.0) << " MB; " << acumulado.acertos << " acertos, "
+		  << acumulado.renderizacoes << " renderizações, " << acumulado.descartes << " descartes, "
+		  << acumulado.recusas << " recusas\n";
+}
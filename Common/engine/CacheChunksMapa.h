@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Renderizador.h"
+
+struct EstatisticasCacheChunks {
+	uint64_t acertos = 0;
+	uint64_t renderizacoes = 0; // chunks desenhados na textura (novos, invalidados ou com outro zoom)
+	uint64_t descartes = 0;     // texturas liberadas para caber no orçamento
+	uint64_t recusas = 0;       // chunks que não couberam (desenhados tile a tile)
+};
+
+// Cache de chunks estáticos do mapa renderizados em textura. Cada chunk é desenhado
+// uma vez num framebuffer, na escala do zoom (texels por unidade do mundo), e nos
+// frames seguintes vira um único quad. A textura é refeita quando o chunk é
+// invalidado (troca de tile) ou quando a escala muda. As texturas somam no máximo
+// orcamentoBytes: um chunk novo descarta os usados há mais tempo e, se nem assim
+// couber (todos usados no frame), comecar() devolve false e o chunk deve ser
+// desenhado diretamente.
+//
+// A textura guarda a cor com alfa pré-multiplicado: na composição o blend é
+// glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA).
+//
+//   GLuint tex = cache.textura(chunk, zoom);
+//   glm::mat4 projecao;
+//   if (!tex && cache.comecar(chunk, limites, zoom, projecao)) {
+//       ... desenha os tiles do chunk com projecao (view = identidade) ...
+//       tex = cache.terminar();
+//   }
+//   if (tex)
+//       renderizador.desenhar(cache.quad(chunk));
+//   ...
+//   cache.fimDoFrame(); // depois do glfwSwapBuffers
+class CacheChunksMapa {
+public:
+	// Lado máximo da textura de um chunk; acima disso a escala é reduzida
+	static constexpr int TAM_MAX_TEXTURA = 4096;
+
+	bool init(int nChunks, size_t orcamentoBytes);
+	void destruir();
+
+	// Textura válida do chunk nesta escala, ou 0 se ele precisa ser (re)desenhado
+	GLuint textura(int chunk, float escala);
+
+	// Liga o framebuffer com a textura do chunk, que cobre limites (xMin, yMin, xMax,
+	// yMax no mundo), e devolve a projeção que leva esse retângulo à textura
+	bool comecar(int chunk, const glm::vec4 &limites, float escala, glm::mat4 &projecao);
+	// Volta ao framebuffer, viewport e blend de antes do comecar; devolve a textura
+	GLuint terminar();
+
+	// Quad (para o RenderizadorGL) que cobre os limites do chunk com a sua textura
+	QuadTexturizado quad(int chunk) const;
+
+	// Tile do chunk trocado: a textura é refeita no próximo uso
+	void invalidar(int chunk);
+
+	void fimDoFrame();
+
+	size_t bytesUsados() const { return usados; }
+	size_t orcamento() const { return orcamentoBytes; }
+	const EstatisticasCacheChunks &ultimoFrame() const { return ultimo; }
+	void relatorio(std::ostream &saida) const;
+
+private:
+	struct Entrada {
+		int chunk = -1; // -1: posição livre
+		GLuint textura = 0;
+		int largura = 0, altura = 0;
+		float escala = 0.0f;
+		glm::vec4 limites = glm::vec4(0.0f);
+		glm::vec2 tamanho = glm::vec2(0.0f); // no mundo, coberto pela textura
+		bool valida = false;
+		uint64_t ultimoUso = 0;
+	};
+
+	void liberar(int slot);
+	bool abrirEspaco(size_t bytes);
+
+	size_t orcamentoBytes = 0, usados = 0;
+	int tamMaximo = TAM_MAX_TEXTURA;
+	std::vector<int> slotDoChunk;
+	std::vector<Entrada> slots;
+	uint64_t frame = 1;
+
+	GLuint fbo = 0, vao = 0, vbo = 0;
+	int emRenderizacao = -1;
+	GLint viewportAnterior[4] = {};
+	GLint blendAnterior[4] = {};
+
+	EstatisticasCacheChunks atual, ultimo, acumulado;
+};
@@ -0,0 +1,123 @@
+#include "CacheTexturas.h"
+#include "Textura.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// FNV-1a de 64 bits
+static uint64_t hashBytes(const std::vector<unsigned char> &dados)
+{
+	uint64_t h = 1469598103934665603ull;
+	for (unsigned char c : dados)
+	{
+		h ^= c;
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+CacheTexturas &CacheTexturas::instancia()
+{
+	static CacheTexturas cache;
+	return cache;
+}
+
+GLuint CacheTexturas::obter(const std::string &arquivo, int &largura, int &altura, GLint filtro)
+{
+	// Filtros diferentes precisam de objetos de textura diferentes
+	std::string sufixo = filtro == GL_NEAREST ? "#nearest" : "#" + std::to_string(filtro);
+
+	std::error_code erro;
+	std::string chaveCaminho = std::filesystem::weakly_canonical(arquivo, erro).string();
+	if (erro)
+		chaveCaminho = arquivo;
+	chaveCaminho += sufixo;
+
+	std::vector<unsigned char> conteudo;
+	std::string chaveConteudo;
+	auto it = porChave.find(chaveCaminho);
+	if (it == porChave.end() && hashConteudo)
+	{
+		std::ifstream f(arquivo, std::ios::binary);
+		conteudo.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+		char hex[24];
+		snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hashBytes(conteudo));
+		chaveConteudo = std::string("conteudo:") + hex + sufixo;
+		it = porChave.find(chaveConteudo);
+		// Mesmo conteúdo por outro caminho: o caminho vira um apelido da textura
+		if (it != porChave.end())
+		{
+			porChave[chaveCaminho] = it->second;
+			porId[it->second].chaves.push_back(chaveCaminho);
+			it = porChave.find(chaveCaminho);
+		}
+	}
+
+	if (it != porChave.end())
+	{
+		Entrada &e = porId[it->second];
+		e.referencias++;
+		e.carregamentosEvitados++;
+		largura = e.largura;
+		altura = e.altura;
+		return it->second;
+	}
+
+	GLuint id = conteudo.empty() ? loadTexture(arquivo, largura, altura, filtro)
+								 : loadTextureMemoria(conteudo.data(), conteudo.size(), largura, altura, filtro);
+	if (!id)
+		return 0;
+
+	Entrada &e = porId[id];
+	e.chaves.push_back(chaveCaminho);
+	porChave[chaveCaminho] = id;
+	if (!chaveConteudo.empty())
+	{
+		e.chaves.push_back(chaveConteudo);
+		porChave[chaveConteudo] = id;
+	}
+	e.arquivo = arquivo;
+	e.largura = largura;
+	e.altura = altura;
+	e.referencias = 1;
+	e.bytes = bytesTexturaRGBA(largura, altura);
+	bytesTotal += e.bytes;
+	return id;
+}
+
+GLuint CacheTexturas::obter(const std::string &arquivo, GLint filtro)
+{
+	int largura, altura;
+	return obter(arquivo, largura, altura, filtro);
+}
+
+void CacheTexturas::liberar(GLuint id)
+{
+	auto it = porId.find(id);
+	if (it == porId.end())
+		return;
+	if (--it->second.referencias > 0)
+		return;
+
+	bytesTotal -= it->second.bytes;
+	for (const std::string &chave : it->second.chaves)
+		porChave.erase(chave);
+	porId.erase(it);
+	glDeleteTextures(1, &id);
+}
+
+void CacheTexturas::relatorio(std::ostream &saida) const
+{
+	saida << "Texturas: " << porId.size() << ", " << bytesTotal / 1024.0 << " KiB na GPU" << std::endl;
+	for (const auto &par : porId)
+	{
+		const Entrada &e = par.second;
+		saida << "  [" << par.first << "] " << e.arquivo << " " << e.largura << "x" << e.altura << ", "
+			  << e.referencias << " referência(s), " << e.carregamentosEvitados << " carregamento(s) evitado(s), "
+			  << e.bytes / 1024.0 << " KiB" << std::endl;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Cache de texturas com contagem de referências. O mesmo arquivo (pelo caminho
+// canônico) carregado várias vezes é decodificado e enviado para a GPU uma vez só;
+// cada obter() soma uma referência e cada liberar() tira uma, e a textura é apagada
+// quando a última referência é liberada.
+//
+// Com usarHashConteudo(true) o conteúdo do arquivo também entra na chave: arquivos
+// diferentes com os mesmos bytes (cópias do mesmo asset) compartilham a textura.
+//
+//   CacheTexturas &texturas = CacheTexturas::instancia();
+//   GLuint tex = texturas.obter("../assets/Vampirinho.png");
+//   ...
+//   texturas.liberar(tex);
+class CacheTexturas {
+public:
+	static CacheTexturas &instancia();
+
+	GLuint obter(const std::string &arquivo, int &largura, int &altura, GLint filtro = GL_NEAREST);
+	GLuint obter(const std::string &arquivo, GLint filtro = GL_NEAREST);
+	void liberar(GLuint id);
+
+	void usarHashConteudo(bool usar) { hashConteudo = usar; }
+
+	// Texturas vivas e memória de GPU estimada (RGBA8 com a cadeia de mipmaps)
+	size_t quantidade() const { return porId.size(); }
+	size_t bytesGPU() const { return bytesTotal; }
+	void relatorio(std::ostream &saida) const;
+
+private:
+	struct Entrada {
+		std::vector<std::string> chaves; // caminho canônico e, com hash, o conteúdo
+		std::string arquivo;
+		int largura = 0, altura = 0;
+		int referencias = 0;
+		size_t bytes = 0;
+		uint64_t carregamentosEvitados = 0;
+	};
+
+	std::unordered_map<std::string, GLuint> porChave;
+	std::unordered_map<GLuint, Entrada> porId;
+	size_t bytesTotal = 0;
+	bool hashConteudo = false;
+};
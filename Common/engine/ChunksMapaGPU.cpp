@@ -0,0 +1,235 @@
+#include "ChunksMapaGPU.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Geometria.h"
+#include "Shader.h"
+
+namespace {
+
+const GLchar *fonteVertex = R"(
+#version 430
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+layout (location = 2) in uvec4 tile; // linha, coluna, camada (por instância)
+out vec2 tex_coord;
+flat out int camada;
+
+layout (std140) uniform ConstantesFrame {
+	mat4 projection;
+	mat4 view;
+	vec4 viewport;
+	float tempo;
+};
+
+uniform vec2 origem;
+uniform vec2 tamTile;
+
+void main()
+{
+	vec2 canto = origem + vec2(float(tile.y) - float(tile.x), float(tile.y) + float(tile.x)) * tamTile * 0.5;
+	camada = int(tile.z);
+	tex_coord = vec2(texc.s, 1.0 - texc.t);
+	gl_Position = projection * view * vec4(canto + position.xy * tamTile, 0.0, 1.0);
+}
+)";
+
+const GLchar *fonteFragment = R"(
+#version 430
+in vec2 tex_coord;
+flat in int camada;
+out vec4 color;
+uniform sampler2DArray camadas;
+
+void main()
+{
+	color = texture(camadas, vec3(tex_coord, camada));
+}
+)";
+
+// Um chunk por invocação: o comando do chunk desenha os seus tiles ou nada
+const GLchar *fonteCulling = R"(
+#version 430
+layout (local_size_x = 64) in;
+
+struct Chunk {
+	vec4 limites; // xMin, yMin, xMax, yMax no mundo
+	uint primeiroTile;
+	uint nTiles;
+	uint reservado0, reservado1;
+};
+layout (std430, binding = 0) readonly buffer Chunks { Chunk chunks[]; };
+
+struct Comando {
+	uint count;
+	uint instanceCount;
+	uint first;
+	uint baseInstance;
+};
+layout (std430, binding = 1) writeonly buffer Comandos { Comando comandos[]; };
+
+uniform vec4 janela;
+uniform uint nChunks;
+
+void main()
+{
+	uint k = gl_GlobalInvocationID.x;
+	if (k >= nChunks)
+		return;
+
+	vec4 l = chunks[k].limites;
+	bool visivel = l.x <= janela.z && l.z >= janela.x && l.y <= janela.w && l.w >= janela.y;
+	comandos[k] = Comando(4u, visivel ? chunks[k].nTiles : 0u, 0u, chunks[k].primeiroTile);
+}
+)";
+
+struct ChunkGPU {
+	float limites[4];
+	uint32_t primeiroTile, nTiles;
+	uint32_t reservado[2];
+};
+
+struct ComandoIndireto {
+	uint32_t count, instanceCount, first, baseInstance;
+};
+
+struct TileInstancia {
+	uint16_t linha, coluna, camada, reservado;
+};
+
+} // namespace
+
+bool ChunksMapaGPU::suportado()
+{
+	return GLAD_GL_VERSION_4_3;
+}
+
+bool ChunksMapaGPU::init(const uint16_t *tiles, int nLinhas, int nColunas, glm::vec2 origem, glm::vec2 tamTile, int tam)
+{
+	if (!suportado() || nLinhas <= 0 || nColunas <= 0 || nLinhas > 65535 || nColunas > 65535)
+		return false;
+
+	programaTiles = setupShader(fonteVertex, fonteFragment);
+	programaCulling = setupComputeShader(fonteCulling);
+	if (!programaTiles || !programaCulling)
+		return false;
+
+	linhas = nLinhas;
+	colunas = nColunas;
+	tamChunk = std::max(1, tam);
+	chunksPorLinha = (colunas + tamChunk - 1) / tamChunk;
+	int chunksPorColuna = (linhas + tamChunk - 1) / tamChunk;
+	nChunks = chunksPorLinha * chunksPorColuna;
+
+	// Tiles agrupados por chunk (linha a linha dentro do chunk) e o retângulo de cada chunk
+	std::vector<TileInstancia> instancias;
+	instancias.reserve((size_t)linhas * colunas);
+	std::vector<ChunkGPU> chunks(nChunks);
+	primeiroTile.assign(nChunks, 0);
+
+	float w = tamTile.x, h = tamTile.y;
+	for (int ci = 0; ci < chunksPorColuna; ci++)
+	{
+		for (int cj = 0; cj < chunksPorLinha; cj++)
+		{
+			int iMin = ci * tamChunk, iMax = std::min(linhas, iMin + tamChunk) - 1;
+			int jMin = cj * tamChunk, jMax = std::min(colunas, jMin + tamChunk) - 1;
+
+			int c = ci * chunksPorLinha + cj;
+			ChunkGPU &chunk = chunks[c];
+			chunk.limites[0] = origem.x + (jMin - iMax) * w / 2.0f;
+			chunk.limites[1] = origem.y + (jMin + iMin) * h / 2.0f;
+			chunk.limites[2] = origem.x + (jMax - iMin) * w / 2.0f + w;
+			chunk.limites[3] = origem.y + (jMax + iMax) * h / 2.0f + h;
+			chunk.primeiroTile = primeiroTile[c] = (uint32_t)instancias.size();
+			chunk.nTiles = (uint32_t)((iMax - iMin + 1) * (jMax - jMin + 1));
+
+			for (int i = iMin; i <= iMax; i++)
+				for (int j = jMin; j <= jMax; j++)
+					instancias.push_back({(uint16_t)i, (uint16_t)j, tiles[(size_t)i * colunas + j], 0});
+		}
+	}
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+
+	// O mesmo losango do setupTile, cobrindo a camada inteira
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, 20 * sizeof(GLfloat), verticesTile(1), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	// Atributo por instância: o baseInstance de cada comando aponta para o chunk
+	glGenBuffers(1, &instanciasVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanciasVBO);
+	glBufferData(GL_ARRAY_BUFFER, instancias.size() * sizeof(TileInstancia), instancias.data(), GL_STATIC_DRAW);
+	glVertexAttribIPointer(2, 4, GL_UNSIGNED_SHORT, sizeof(TileInstancia), (GLvoid *)0);
+	glEnableVertexAttribArray(2);
+	glVertexAttribDivisor(2, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	glGenBuffers(1, &chunksSSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, chunksSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, chunks.size() * sizeof(ChunkGPU), chunks.data(), GL_STATIC_DRAW);
+
+	// Escrito pelo compute shader e lido pelo glMultiDrawArraysIndirect, sem passar pela CPU
+	glGenBuffers(1, &comandosBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, comandosBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, nChunks * sizeof(ComandoIndireto), nullptr, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	glUseProgram(programaTiles);
+	glUniform2f(glGetUniformLocation(programaTiles, "origem"), origem.x, origem.y);
+	glUniform2f(glGetUniformLocation(programaTiles, "tamTile"), w, h);
+	glUniform1i(glGetUniformLocation(programaTiles, "camadas"), 0);
+	locJanela = glGetUniformLocation(programaCulling, "janela");
+	locNChunks = glGetUniformLocation(programaCulling, "nChunks");
+
+	std::cout << "Mapa em " << nChunks << " chunks de " << tamChunk << "x" << tamChunk << " tiles ("
+			  << instancias.size() * sizeof(TileInstancia) / 1024 << " KB de instâncias)" << std::endl;
+	return true;
+}
+
+uint32_t ChunksMapaGPU::indiceInstancia(int i, int j) const
+{
+	int ci = i / tamChunk, cj = j / tamChunk;
+	int largura = std::min(colunas, (cj + 1) * tamChunk) - cj * tamChunk;
+	return primeiroTile[ci * chunksPorLinha + cj] + (uint32_t)((i - ci * tamChunk) * largura + (j - cj * tamChunk));
+}
+
+void ChunksMapaGPU::atualizarTile(int i, int j, uint16_t id)
+{
+	if (!vao)
+		return;
+	glBindBuffer(GL_ARRAY_BUFFER, instanciasVBO);
+	glBufferSubData(GL_ARRAY_BUFFER, indiceInstancia(i, j) * sizeof(TileInstancia) + offsetof(TileInstancia, camada),
+					sizeof(uint16_t), &id);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunksMapaGPU::desenhar(const glm::vec4 &janela, GLuint tileset)
+{
+	glUseProgram(programaCulling);
+	glUniform4f(locJanela, janela.x, janela.y, janela.z, janela.w);
+	glUniform1ui(locNChunks, (GLuint)nChunks);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, chunksSSBO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, comandosBuffer);
+	glDispatchCompute((GLuint)(nChunks + 63) / 64, 1, 1);
+	// Os comandos escritos pelo compute shader precisam estar visíveis para o draw
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+	glUseProgram(programaTiles);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, tileset);
+	glBindVertexArray(vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, comandosBuffer);
+	glMultiDrawArraysIndirect(GL_TRIANGLE_STRIP, nullptr, nChunks, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Mapa isométrico desenhado e recortado inteiramente pela GPU. O mapa é dividido em
+// chunks de tamChunk x tamChunk tiles; os tiles ficam num buffer estático de
+// instâncias (linha, coluna e camada do tileset, 8 bytes por tile), agrupados por
+// chunk, e o retângulo de cada chunk no mundo fica num SSBO. A cada frame um compute
+// shader compara os chunks com a janela e escreve um DrawArraysIndirectCommand por
+// chunk (instanceCount = 0 nos que estão fora), e o mapa inteiro sai num único
+// glMultiDrawArraysIndirect: a CPU não faz nenhum trabalho por chunk.
+//
+// Precisa de OpenGL 4.3 (compute shader e multi-draw indirect; o llvmpipe do Mesa
+// serve). Sem isso, suportado() é false e o culling fica com a CPU (desenharMapa no
+// Desafio). O tileset é uma textura array com um tile por camada (loadTextureArray),
+// ligada na unidade 0; projection e view vêm do ConstantesFrame.
+//
+//   ChunksMapaGPU chunks;
+//   chunks.init(mapData.data(), linhas, colunas, origem, tamTile);
+//   ...
+//   chunks.desenhar(vec4(xMin, yMin, xMax, yMax), tileset); // janela no mundo
+//   chunks.atualizarTile(i, j, novoId);                     // tile trocado no jogo
+class ChunksMapaGPU {
+public:
+	static bool suportado();
+
+	// tiles linha a linha; o canto do tile [i][j] fica em
+	// origem + ((j - i) * tamTile.x / 2, (j + i) * tamTile.y / 2). Até 65535 linhas e colunas.
+	bool init(const uint16_t *tiles, int linhas, int colunas, glm::vec2 origem, glm::vec2 tamTile, int tamChunk = 32);
+
+	void atualizarTile(int i, int j, uint16_t id);
+
+	// Culling dos chunks contra janela (xMin, yMin, xMax, yMax) e desenho. Deixa o
+	// programa de tiles em uso.
+	void desenhar(const glm::vec4 &janela, GLuint tileset);
+
+	int quantidadeChunks() const { return nChunks; }
+	int tamanhoChunk() const { return tamChunk; }
+
+private:
+	uint32_t indiceInstancia(int i, int j) const;
+
+	int linhas = 0, colunas = 0, tamChunk = 32;
+	int chunksPorLinha = 0, nChunks = 0;
+	std::vector<uint32_t> primeiroTile; // por chunk, no buffer de instâncias
+
+	GLuint programaTiles = 0, programaCulling = 0;
+	GLint locJanela = -1, locNChunks = -1;
+	GLuint vao = 0, quadVBO = 0, instanciasVBO = 0, chunksSSBO = 0, comandosBuffer = 0;
+};
@@ -0,0 +1,27 @@
+#include "ConstantesFrame.h"
+
+static_assert(sizeof(ConstantesFrame) == 160, "ConstantesFrame deve seguir o layout std140 do bloco");
+
+void ligarConstantesFrame(GLuint programa)
+{
+	GLuint indice = glGetUniformBlockIndex(programa, "ConstantesFrame");
+	if (indice != GL_INVALID_INDEX)
+		glUniformBlockBinding(programa, indice, PONTO_CONSTANTES_FRAME);
+}
+
+bool BlocoConstantesFrame::init()
+{
+	glGenBuffers(1, &ubo);
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(ConstantesFrame), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	return ubo != 0;
+}
+
+void BlocoConstantesFrame::atualizar(const ConstantesFrame &constantes)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(ConstantesFrame), &constantes);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, PONTO_CONSTANTES_FRAME, ubo);
+}
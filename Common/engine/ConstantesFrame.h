@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Constantes que valem para o frame inteiro, num uniform buffer ligado uma vez por
+// frame ao ponto PONTO_CONSTANTES_FRAME e compartilhado por todos os programas.
+// Nos shaders:
+//
+//   layout (std140) uniform ConstantesFrame {
+//       mat4 projection;
+//       mat4 view;
+//       vec4 viewport; // x, y, largura, altura
+//       float tempo;   // segundos
+//   };
+//
+// setupShader (e ProgramaShader, que passa por ele ou pelo cache de binários) liga
+// o bloco ao ponto automaticamente; programas sem o bloco não são afetados.
+//
+//   BlocoConstantesFrame constantes;
+//   constantes.init();
+//   ...
+//   constantes.atualizar({projection, view, vec4(0, 0, largura, altura), tempo});
+struct ConstantesFrame {
+	glm::mat4 projection = glm::mat4(1.0f);
+	glm::mat4 view = glm::mat4(1.0f);
+	glm::vec4 viewport = glm::vec4(0.0f);
+	float tempo = 0.0f;
+	float preenchimento[3] = {}; // std140: o bloco ocupa múltiplos de 16 bytes
+};
+
+constexpr GLuint PONTO_CONSTANTES_FRAME = 0;
+
+// Liga o bloco ConstantesFrame do programa (se existir) ao ponto do frame
+void ligarConstantesFrame(GLuint programa);
+
+class BlocoConstantesFrame {
+public:
+	bool init();
+
+	// Um envio de 160 bytes e um glBindBufferBase por frame
+	void atualizar(const ConstantesFrame &constantes);
+
+	GLuint buffer() const { return ubo; }
+
+private:
+	GLuint ubo = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+// Biblioteca compartilhada pelos exercícios (alvo "engine" no CMakeLists.txt):
+// shaders, texturas (com cache), geometria de sprites/tiles, spritesheets recortadas,
+// renderizadores (OpenGL e CPU), buffer de streaming, constantes do frame (UBO),
+// mapa em chunks (recortado na GPU, em cache de texturas ou em impostores para o zoom
+// afastado), medição de tempo, arena por frame e contagem de alocações e de chamadas OpenGL
+#include "Alocacoes.h"
+#include "ArenaFrame.h"
+#include "BufferStreaming.h"
+#include "CacheChunksMapa.h"
+#include "CacheTexturas.h"
+#include "ChunksMapaGPU.h"
+#include "ConstantesFrame.h"
+#include "Geometria.h"
+#include "ImpostoresMapa.h"
+#include "InstrumentacaoGL.h"
+#include "ProgramaShader.h"
+#include "RasterizadorCPU.h"
+#include "Renderizador.h"
+#include "Shader.h"
+#include "SpriteSheet.h"
+#include "Tempo.h"
+#include "Textura.h"
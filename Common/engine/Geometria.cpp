@@ -0,0 +1,96 @@
+#include "Geometria.h"
+
+#include <array>
+#include <map>
+#include <utility>
+
+// Cria o VBO e o VAO de 4 vértices (x, y, z, s, t), desenhados como GL_TRIANGLE_STRIP
+static GLuint criarQuad(const GLfloat *vertices)
+{
+	GLuint VBO, VAO;
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, 4 * 5 * sizeof(GLfloat), vertices, GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+
+	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+
+	// Ponteiro pro atributo 1 - Coordenada de textura s, t
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return VAO;
+}
+
+const GLfloat *verticesSprite(int nAnimations, int nFrames)
+{
+	static std::map<std::pair<int, int>, std::array<GLfloat, 20>> criados;
+	auto it = criados.find({nAnimations, nFrames});
+	if (it != criados.end())
+		return it->second.data();
+
+	GLfloat ds = 1.0 / (float)nFrames;
+	GLfloat dt = 1.0 / (float)nAnimations;
+	std::array<GLfloat, 20> vertices = {
+		// x   y    z    s     t
+		-0.5,  0.5, 0.0, 0.0, dt,  //V0
+		-0.5, -0.5, 0.0, 0.0, 0.0, //V1
+		 0.5,  0.5, 0.0, ds,  dt,  //V2
+		 0.5, -0.5, 0.0, ds,  0.0  //V3
+	};
+	return criados.emplace(std::make_pair(nAnimations, nFrames), vertices).first->second.data();
+}
+
+const GLfloat *verticesTile(int nTiles)
+{
+	static std::map<int, std::array<GLfloat, 20>> criados;
+	auto it = criados.find(nTiles);
+	if (it != criados.end())
+		return it->second.data();
+
+	GLfloat ds = 1.0 / (float)nTiles;
+	GLfloat dt = 1.0;
+
+	// Quad unitário: o tamanho do tile vem da escala na matriz model
+	float th = 1.0, tw = 1.0;
+
+	std::array<GLfloat, 20> vertices = {
+		// x   y    z    s     t
+		0.0,     th / 2.0f, 0.0, 0.0,       dt / 2.0f, //A
+		tw / 2.0f, th,      0.0, ds / 2.0f, dt,        //B
+		tw / 2.0f, 0.0,     0.0, ds / 2.0f, 0.0,       //D
+		tw,      th / 2.0f, 0.0, ds,        dt / 2.0f  //C
+	};
+	return criados.emplace(nTiles, vertices).first->second.data();
+}
+
+GLuint setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+{
+	ds = 1.0 / (float)nFrames;
+	dt = 1.0 / (float)nAnimations;
+
+	static std::map<std::pair<int, int>, GLuint> criados;
+	GLuint &VAO = criados[{nAnimations, nFrames}];
+	if (!VAO)
+		VAO = criarQuad(verticesSprite(nAnimations, nFrames));
+	return VAO;
+}
+
+GLuint setupTile(int nTiles, float &ds, float &dt)
+{
+	ds = 1.0 / (float)nTiles;
+	dt = 1.0;
+
+	static std::map<int, GLuint> criados;
+	GLuint &VAO = criados[nTiles];
+	if (!VAO)
+		VAO = criarQuad(verticesTile(nTiles));
+	return VAO;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Quads usados pelos sprites e pelos tiles. Layout dos VAOs: location 0 = posição
+// (vec3), location 1 = coordenada de textura (vec2).
+//
+// A geometria só depende dos parâmetros, então cada combinação é criada uma única
+// vez e o mesmo VAO é devolvido nas chamadas seguintes (um tileset de n tiles usa
+// um VAO, e não n VAOs iguais).
+
+// Quad unitário centrado na origem, mostrando um frame de uma spritesheet de
+// nAnimations linhas por nFrames colunas (ds, dt = tamanho do frame na textura)
+GLuint setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
+
+// Losango 2:1 em um quad unitário com canto em (0, 0), mostrando um tile de um
+// tileset em faixa horizontal com nTiles tiles
+GLuint setupTile(int nTiles, float &ds, float &dt);
+
+// Os mesmos 4 vértices (x, y, z, s, t) em memória, para quem desenha sem OpenGL
+// (RasterizadorCPU). O ponteiro continua válido até o fim do programa.
+const GLfloat *verticesSprite(int nAnimations, int nFrames);
+const GLfloat *verticesTile(int nTiles);
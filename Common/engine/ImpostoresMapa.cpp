@@ -0,0 +1,424 @@
+#include "ImpostoresMapa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "CullingIso.h"
+#include "Geometria.h"
+#include "Shader.h"
+
+namespace {
+
+// Nível 0: os tiles de um chunk numa chamada instanciada; o ID de cada tile vem de
+// uma textura R16UI com o chunk
+const GLchar *fonteVertexTiles = R"(
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+out vec2 tex_coord;
+flat out int camada;
+
+uniform mat4 transformacao;
+uniform usampler2D tilesChunk;
+uniform ivec2 primeiroTile; // linha e coluna do primeiro tile do chunk
+uniform int colunasChunk;
+uniform vec2 origem;
+uniform vec2 tamTile;
+
+void main()
+{
+	int di = gl_InstanceID / colunasChunk, dj = gl_InstanceID % colunasChunk;
+	camada = int(texelFetch(tilesChunk, ivec2(dj, di), 0).r);
+
+	float i = float(primeiroTile.x + di), j = float(primeiroTile.y + dj);
+	vec2 canto = origem + vec2(j - i, j + i) * tamTile * 0.5;
+	tex_coord = vec2(texc.s, 1.0 - texc.t);
+	gl_Position = transformacao * vec4(canto + position.xy * tamTile, 0.0, 1.0);
+}
+)";
+
+const GLchar *fonteFragmentTiles = R"(
+#version 400
+in vec2 tex_coord;
+flat in int camada;
+out vec4 color;
+uniform sampler2DArray camadas;
+
+void main()
+{
+	color = texture(camadas, vec3(tex_coord, camada));
+}
+)";
+
+// Uma célula do atlas esticada sobre o retângulo que ela cobre no mundo: monta os
+// níveis acima do 0 e desenha o mapa de longe
+const GLchar *fonteVertexCelulas = R"(
+#version 400
+layout (location = 0) in vec2 canto;
+out vec2 tex_coord;
+
+uniform mat4 transformacao;
+uniform vec4 retangulo; // x, y, largura, altura no mundo
+uniform vec4 regiaoTex; // s0, t0, s1, t1 no atlas
+
+void main()
+{
+	tex_coord = mix(regiaoTex.xy, regiaoTex.zw, canto);
+	gl_Position = transformacao * vec4(retangulo.xy + canto * retangulo.zw, 0.0, 1.0);
+}
+)";
+
+const GLchar *fonteFragmentCelulas = R"(
+#version 400
+in vec2 tex_coord;
+out vec4 color;
+uniform sampler2D atlas;
+
+void main()
+{
+	color = texture(atlas, tex_coord);
+}
+)";
+
+const GLfloat verticesCelula[] = {
+	0.0, 0.0,
+	0.0, 1.0,
+	1.0, 0.0,
+	1.0, 1.0,
+};
+
+} // namespace
+
+bool ImpostoresMapa::init(const uint16_t *dados, int nLinhas, int nColunas, glm::vec2 origemMapa, glm::vec2 tamanhoTile,
+						  GLuint texTileset, float zoomLimiar, size_t orcamentoBytes, int tam)
+{
+	auto inicio = std::chrono::steady_clock::now();
+
+	tiles = dados;
+	linhas = nLinhas;
+	colunas = nColunas;
+	origem = origemMapa;
+	tamTile = tamanhoTile;
+	tileset = texTileset;
+	limiar = zoomLimiar;
+	tamChunk = std::max(1, tam);
+
+	int chunksX = (colunas + tamChunk - 1) / tamChunk;
+	int chunksY = (linhas + tamChunk - 1) / tamChunk;
+	float larguraChunk = tamChunk * tamTile.x, alturaChunk = tamChunk * tamTile.y;
+
+	// Densidade do nível 0: o limiar, se o atlas couber na textura e os níveis (4/3
+	// do nível 0) no orçamento
+	GLint maxTextura = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextura);
+	float escala = limiar;
+	escala = std::min(escala, (maxTextura / chunksX - 2) / larguraChunk);
+	escala = std::min(escala, (maxTextura / chunksY - 2) / alturaChunk);
+	escala = std::min(escala, std::sqrt(orcamentoBytes * 3.0f / 16.0f / ((float)chunksX * chunksY * larguraChunk * alturaChunk)));
+
+	larguraCelula = (int)(larguraChunk * escala) + 2;
+	alturaCelula = (int)(alturaChunk * escala) + 2;
+	if (larguraCelula < 4 || alturaCelula < 4)
+	{
+		std::cout << "Mapa " << colunas << "x" << linhas << " grande demais para os impostores (" << maxTextura
+				  << " texels por lado, " << orcamentoBytes / (1024 * 1024) << " MB): LOD desativado" << std::endl;
+		return false;
+	}
+	escala0 = (larguraCelula - 2) / larguraChunk;
+
+	programaTiles = setupShader(fonteVertexTiles, fonteFragmentTiles);
+	programaCelulas = setupShader(fonteVertexCelulas, fonteFragmentCelulas);
+	if (!programaTiles || !programaCelulas)
+		return false;
+
+	glUseProgram(programaTiles);
+	glUniform2f(glGetUniformLocation(programaTiles, "origem"), origem.x, origem.y);
+	glUniform2f(glGetUniformLocation(programaTiles, "tamTile"), tamTile.x, tamTile.y);
+	glUniform1i(glGetUniformLocation(programaTiles, "camadas"), 0);
+	glUniform1i(glGetUniformLocation(programaTiles, "tilesChunk"), 1);
+	locTransfTiles = glGetUniformLocation(programaTiles, "transformacao");
+	locPrimeiroTile = glGetUniformLocation(programaTiles, "primeiroTile");
+	locColunasChunk = glGetUniformLocation(programaTiles, "colunasChunk");
+
+	glUseProgram(programaCelulas);
+	glUniform1i(glGetUniformLocation(programaCelulas, "atlas"), 0);
+	locTransfCelulas = glGetUniformLocation(programaCelulas, "transformacao");
+	locRetangulo = glGetUniformLocation(programaCelulas, "retangulo");
+	locRegiaoTex = glGetUniformLocation(programaCelulas, "regiaoTex");
+	glUseProgram(0);
+
+	// O losango do tile (o mesmo do setupTile) e o quad unitário das células
+	glGenVertexArrays(1, &vaoTile);
+	glBindVertexArray(vaoTile);
+	glGenBuffers(1, &vboTile);
+	glBindBuffer(GL_ARRAY_BUFFER, vboTile);
+	glBufferData(GL_ARRAY_BUFFER, 20 * sizeof(GLfloat), verticesTile(1), GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	glGenVertexArrays(1, &vaoCelula);
+	glBindVertexArray(vaoCelula);
+	glGenBuffers(1, &vboCelula);
+	glBindBuffer(GL_ARRAY_BUFFER, vboCelula);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(verticesCelula), verticesCelula, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	glGenTextures(1, &texTilesChunk);
+	glBindTexture(GL_TEXTURE_2D, texTilesChunk);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, tamChunk, tamChunk, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+
+	// Um atlas por nível, cada um com metade das células (por eixo) do anterior
+	int cx = chunksX, cy = chunksY;
+	while (true)
+	{
+		Nivel n;
+		n.celulasX = cx;
+		n.celulasY = cy;
+		n.sujo.assign((size_t)cx * cy, 1);
+		glGenTextures(1, &n.atlas);
+		glBindTexture(GL_TEXTURE_2D, n.atlas);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cx * larguraCelula, cy * alturaCelula, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		bytesAtlas += (size_t)cx * larguraCelula * cy * alturaCelula * 4;
+		niveis.push_back(std::move(n));
+
+		if (cx == 1 && cy == 1)
+			break;
+		cx = (cx + 1) / 2;
+		cy = (cy + 1) / 2;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &fbo);
+
+	// Todas as células começam sujas: a primeira passada monta todos os níveis
+	haSujas = true;
+	refazerSujas();
+	glFinish();
+
+	pronto = true;
+	segundosPreparo = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+	relatorio(std::cout);
+	return true;
+}
+
+// Retângulo nominal da célula (x, y, largura, altura): o de um bloco completo de
+// (tamChunk << nivel) tiles, mesmo nas bordas do mapa
+glm::vec4 ImpostoresMapa::retanguloCelula(int nivel, int ci, int cj) const
+{
+	int t = tamChunk << nivel;
+	int iMin = ci * t, jMin = cj * t;
+	return glm::vec4(origem.x + (jMin - (iMin + t - 1)) * tamTile.x / 2.0f, origem.y + (jMin + iMin) * tamTile.y / 2.0f,
+					 t * tamTile.x, t * tamTile.y);
+}
+
+// A linha 0 do atlas é o y menor da célula (a projeção do framebuffer não inverte y)
+glm::vec4 ImpostoresMapa::regiaoTexCelula(int nivel, int ci, int cj) const
+{
+	const Nivel &n = niveis[nivel];
+	float w = (float)(n.celulasX * larguraCelula), h = (float)(n.celulasY * alturaCelula);
+	return glm::vec4((cj * larguraCelula + 1) / w, (ci * alturaCelula + 1) / h,
+					 ((cj + 1) * larguraCelula - 1) / w, ((ci + 1) * alturaCelula - 1) / h);
+}
+
+// Limpa a célula (com a borda) e deixa a viewport no seu interior
+void ImpostoresMapa::comecarCelula(int nivel, int ci, int cj)
+{
+	int x = cj * larguraCelula, y = ci * alturaCelula;
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(x, y, larguraCelula, alturaCelula);
+	const GLfloat transparente[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+	glClearBufferfv(GL_COLOR, 0, transparente);
+	glDisable(GL_SCISSOR_TEST);
+	glViewport(x + 1, y + 1, larguraCelula - 2, alturaCelula - 2);
+
+	glm::vec4 r = retanguloCelula(nivel, ci, cj);
+	glm::mat4 transformacao = glm::ortho(r.x, r.x + r.z, r.y, r.y + r.w, -1.0f, 1.0f);
+	glUniformMatrix4fv(nivel == 0 ? locTransfTiles : locTransfCelulas, 1, GL_FALSE, glm::value_ptr(transformacao));
+}
+
+void ImpostoresMapa::desenharTilesCelula(int ci, int cj)
+{
+	int iMin = ci * tamChunk, jMin = cj * tamChunk;
+	int nLinhas = std::min(tamChunk, linhas - iMin), nColunas = std::min(tamChunk, colunas - jMin);
+
+	// O chunk é lido direto do mapa, linha a linha
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, texTilesChunk);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, colunas);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, nColunas, nLinhas, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+					tiles + (size_t)iMin * colunas + jMin);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glActiveTexture(GL_TEXTURE0);
+
+	glUniform2i(locPrimeiroTile, iMin, jMin);
+	glUniform1i(locColunasChunk, nColunas);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, nLinhas * nColunas);
+}
+
+// As até 2x2 células filhas (nível - 1), na ordem de desenho do mapa
+void ImpostoresMapa::desenharFilhas(int nivel, int ci, int cj)
+{
+	const Nivel &filho = niveis[nivel - 1];
+	for (int a = 0; a < 2; a++)
+	{
+		for (int b = 0; b < 2; b++)
+		{
+			int fi = 2 * ci + a, fj = 2 * cj + b;
+			if (fi >= filho.celulasY || fj >= filho.celulasX)
+				continue;
+			glUniform4fv(locRetangulo, 1, glm::value_ptr(retanguloCelula(nivel - 1, fi, fj)));
+			glUniform4fv(locRegiaoTex, 1, glm::value_ptr(regiaoTexCelula(nivel - 1, fi, fj)));
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+}
+
+// Refaz as células dos chunks marcados e, nível a nível, as que contêm células refeitas
+void ImpostoresMapa::refazerSujas()
+{
+	if (!haSujas)
+		return;
+
+	GLint viewport[4], programa, blend[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programa);
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blend[0]);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blend[1]);
+	glGetIntegerv(GL_BLEND_SRC_ALPHA, &blend[2]);
+	glGetIntegerv(GL_BLEND_DST_ALPHA, &blend[3]);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glActiveTexture(GL_TEXTURE0);
+
+	for (size_t nivel = 0; nivel < niveis.size(); nivel++)
+	{
+		Nivel &n = niveis[nivel];
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, n.atlas, 0);
+
+		if (nivel == 0)
+		{
+			// Tiles com cor pré-multiplicada e alfa acumulado
+			glUseProgram(programaTiles);
+			glBindVertexArray(vaoTile);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, tileset);
+			glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			// Células já pré-multiplicadas, reduzidas 2:1 pela filtragem linear
+			glUseProgram(programaCelulas);
+			glBindVertexArray(vaoCelula);
+			glBindTexture(GL_TEXTURE_2D, niveis[nivel - 1].atlas);
+			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		Nivel *pai = nivel + 1 < niveis.size() ? &niveis[nivel + 1] : nullptr;
+		for (int ci = 0; ci < n.celulasY; ci++)
+		{
+			for (int cj = 0; cj < n.celulasX; cj++)
+			{
+				uint8_t &sujo = n.sujo[(size_t)ci * n.celulasX + cj];
+				if (!sujo)
+					continue;
+				comecarCelula((int)nivel, ci, cj);
+				if (nivel == 0)
+					desenharTilesCelula(ci, cj);
+				else
+					desenharFilhas((int)nivel, ci, cj);
+				sujo = 0;
+				if (pai)
+					pai->sujo[(size_t)(ci / 2) * pai->celulasX + cj / 2] = 1;
+			}
+		}
+	}
+	haSujas = false;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glBindVertexArray(0);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glUseProgram(programa);
+	glBlendFuncSeparate(blend[0], blend[1], blend[2], blend[3]);
+}
+
+int ImpostoresMapa::nivelPara(float zoom) const
+{
+	int nivel = 0;
+	while (nivel + 1 < (int)niveis.size() && escala0 / (float)(2 << nivel) >= zoom)
+		nivel++;
+	return nivel;
+}
+
+void ImpostoresMapa::atualizarTile(int i, int j)
+{
+	if (!pronto)
+		return;
+	Nivel &n = niveis[0];
+	n.sujo[(size_t)(i / tamChunk) * n.celulasX + j / tamChunk] = 1;
+	haSujas = true;
+}
+
+void ImpostoresMapa::desenhar(const glm::mat4 &projecaoView, const glm::vec4 &janela, float zoom)
+{
+	refazerSujas();
+
+	int nivel = nivelPara(zoom);
+	const Nivel &n = niveis[nivel];
+	int t = tamChunk << nivel;
+
+	// Linhas e colunas de tiles na janela (Common/CullingIso.h), convertidas em células
+	FaixaIso faixa = faixaVisivelIso(origem.x, origem.y, tamTile.x, tamTile.y, linhas, colunas,
+									 janela.x, janela.z, janela.y, janela.w);
+	int jMin = std::max(0, (int)std::floor((faixa.sMin + faixa.dMin) / 2.0f));
+	int jMax = std::min(colunas - 1, (int)std::ceil((faixa.sMax + faixa.dMax) / 2.0f));
+	ultimasCelulas = 0;
+	if (faixa.iMin > faixa.iMax || jMin > jMax)
+		return;
+
+	glUseProgram(programaCelulas);
+	glUniformMatrix4fv(locTransfCelulas, 1, GL_FALSE, glm::value_ptr(projecaoView));
+	glBindVertexArray(vaoCelula);
+	glBindTexture(GL_TEXTURE_2D, n.atlas);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	for (int ci = faixa.iMin / t; ci <= faixa.iMax / t; ci++)
+	{
+		for (int cj = jMin / t; cj <= jMax / t; cj++)
+		{
+			glm::vec4 r = retanguloCelula(nivel, ci, cj);
+			if (r.x > janela.z || r.x + r.z < janela.x || r.y > janela.w || r.y + r.w < janela.y)
+				continue;
+			glUniform4fv(locRetangulo, 1, glm::value_ptr(r));
+			glUniform4fv(locRegiaoTex, 1, glm::value_ptr(regiaoTexCelula(nivel, ci, cj)));
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			ultimasCelulas++;
+		}
+	}
+
+	glBindVertexArray(0);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ImpostoresMapa::relatorio(std::ostream &saida) const
+{
+	saida << "Impostores do mapa: " << niveis.size() << " níveis de células " << larguraCelula << "x" << alturaCelula
+		  << " (" << bytesAtlas / (1024.0 * 1024.0) << " MB), " << escala0 << " texels por unidade do mundo no nível 0, "
+		  << "usados abaixo do zoom " << limiar << "; preparo em " << segundosPreparo * 1000.0 << " ms\n";
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Nível de detalhe para o mapa isométrico visto de longe. Na carga, cada chunk de
+// tamChunk x tamChunk tiles é desenhado numa célula de um atlas (nível 0); cada nível
+// seguinte junta 2x2 células do anterior numa célula do mesmo tamanho, até uma célula
+// cobrir o mapa inteiro. Abaixo de zoomLimiar, desenhar() usa o nível cuja densidade
+// de texels é a mais próxima acima da da tela, então o número de quads (um por célula
+// visível) fica limitado pelo tamanho da janela e não pelo do mapa.
+//
+// A densidade do nível 0 é zoomLimiar, reduzida se o atlas não couber em
+// GL_MAX_TEXTURE_SIZE ou os níveis somados passarem de orcamentoBytes (nesse caso,
+// logo abaixo do limiar a imagem fica um pouco borrada). As células guardam cor
+// pré-multiplicada; desenhar() liga o próprio programa e o blend de composição e
+// devolve o blend para glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+//
+// O tileset é uma textura array com um tile por camada (loadTextureArray). Os tiles
+// são lidos do vetor do jogo, que precisa continuar vivo: atualizarTile() só marca o
+// chunk, e o próximo desenhar() refaz a célula dele e as dos níveis acima.
+//
+//   ImpostoresMapa lod;
+//   lod.init(mapData.data(), linhas, colunas, origem, tamTile, tileset, 0.4f, 64 << 20);
+//   ...
+//   if (lod.usar(zoom))
+//       lod.desenhar(projection * view, vec4(xMin, yMin, xMax, yMax), zoom);
+class ImpostoresMapa {
+public:
+	bool init(const uint16_t *tiles, int linhas, int colunas, glm::vec2 origem, glm::vec2 tamTile, GLuint tileset,
+			  float zoomLimiar, size_t orcamentoBytes, int tamChunk = 32);
+
+	bool usar(float zoom) const { return pronto && zoom < limiar; }
+
+	// Nível usado no zoom: o mais grosso com pelo menos um texel por pixel
+	int nivelPara(float zoom) const;
+
+	void atualizarTile(int i, int j);
+
+	// Células visíveis na janela (xMin, yMin, xMax, yMax no mundo)
+	void desenhar(const glm::mat4 &projecaoView, const glm::vec4 &janela, float zoom);
+
+	int quantidadeNiveis() const { return (int)niveis.size(); }
+	int celulasUltimoDesenho() const { return ultimasCelulas; }
+	void relatorio(std::ostream &saida) const;
+
+private:
+	struct Nivel {
+		GLuint atlas = 0;
+		int celulasX = 0, celulasY = 0; // células por linha e por coluna do atlas
+		std::vector<uint8_t> sujo;      // por célula, para refazer depois de atualizarTile
+	};
+
+	glm::vec4 retanguloCelula(int nivel, int ci, int cj) const;
+	glm::vec4 regiaoTexCelula(int nivel, int ci, int cj) const;
+	void comecarCelula(int nivel, int ci, int cj);
+	void desenharTilesCelula(int ci, int cj);
+	void desenharFilhas(int nivel, int ci, int cj);
+	void refazerSujas();
+
+	const uint16_t *tiles = nullptr;
+	int linhas = 0, colunas = 0, tamChunk = 32;
+	glm::vec2 origem = glm::vec2(0.0f), tamTile = glm::vec2(1.0f);
+	GLuint tileset = 0;
+	float limiar = 0.0f;
+	bool pronto = false;
+
+	// Células de larguraCelula x alturaCelula texels, com 1 texel de borda vazia para
+	// a filtragem não puxar a célula vizinha do atlas
+	int larguraCelula = 0, alturaCelula = 0;
+	float escala0 = 0.0f; // texels por unidade do mundo no nível 0
+	std::vector<Nivel> niveis;
+	bool haSujas = false;
+	size_t bytesAtlas = 0;
+	double segundosPreparo = 0.0;
+	int ultimasCelulas = 0;
+
+	GLuint programaTiles = 0, programaCelulas = 0;
+	GLint locTransfTiles = -1, locPrimeiroTile = -1, locColunasChunk = -1;
+	GLint locTransfCelulas = -1, locRetangulo = -1, locRegiaoTex = -1;
+	GLuint vaoTile = 0, vboTile = 0, vaoCelula = 0, vboCelula = 0;
+	GLuint texTilesChunk = 0, fbo = 0;
+};
@@ -0,0 +1,314 @@
+#include "InstrumentacaoGL.h"
+
+#ifdef PG_INSTRUMENTAR_GL
+
+#include <cstdio>
+#include <iostream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+namespace {
+
+enum class CategoriaGL { Draw, Bind, Uniform, Upload, Estado, Outra };
+
+ContadoresGL atual, ultimo;
+bool verificar = false;
+PFNGLGETERRORPROC getErrorOriginal = nullptr;
+
+// O que está ligado agora, para achar binds redundantes
+struct Ligados {
+	GLuint vao = 0, programa = 0;
+	GLenum unidade = GL_TEXTURE0;
+	std::unordered_map<uint64_t, GLuint> texturas; // (unidade << 32) | alvo
+	std::unordered_map<uint64_t, GLuint> buffers;  // alvo, ou (índice << 32) | alvo no glBindBufferBase
+	std::unordered_map<GLenum, GLuint> framebuffers;
+} ligados;
+
+void contar(CategoriaGL categoria)
+{
+	atual.chamadas++;
+	switch (categoria) {
+	case CategoriaGL::Draw: atual.draws++; break;
+	case CategoriaGL::Bind: atual.binds++; break;
+	case CategoriaGL::Uniform: atual.uniforms++; break;
+	case CategoriaGL::Upload: atual.uploads++; break;
+	case CategoriaGL::Estado: atual.estado++; break;
+	case CategoriaGL::Outra: break;
+	}
+}
+
+void verificarErro(const char *nome)
+{
+#ifndef NDEBUG
+	if (!verificar)
+		return;
+	for (GLenum erro = getErrorOriginal(); erro != GL_NO_ERROR; erro = getErrorOriginal()) {
+		atual.erros++;
+		fprintf(stderr, "GL: erro 0x%04X em %s\n", erro, nome);
+	}
+#else
+	(void)nome;
+#endif
+}
+
+// Troca um ponteiro da GLAD por chamar(): conta, chama o observador (se houver) com
+// os mesmos argumentos, chama a função original e verifica erros
+template <auto *Var, auto Observador = nullptr, typename F = std::remove_reference_t<decltype(*Var)>>
+struct Gancho;
+
+template <auto *Var, auto Observador, typename R, typename... A>
+struct Gancho<Var, Observador, R(APIENTRYP)(A...)> {
+	static inline R(APIENTRYP original)(A...) = nullptr;
+	static inline CategoriaGL categoria = CategoriaGL::Outra;
+	static inline const char *nome = "";
+
+	static R APIENTRY chamar(A... a)
+	{
+		contar(categoria);
+		if constexpr (!std::is_same_v<decltype(Observador), std::nullptr_t>)
+			Observador(a...);
+		if constexpr (std::is_void_v<R>) {
+			original(a...);
+			verificarErro(nome);
+		}
+		else {
+			R r = original(a...);
+			verificarErro(nome);
+			return r;
+		}
+	}
+
+	static void instalar(CategoriaGL c, const char *n)
+	{
+		// Função não carregada (versão do contexto) ou já instalada
+		if (!*Var || original)
+			return;
+		original = *Var;
+		categoria = c;
+		nome = n;
+		*Var = &chamar;
+	}
+};
+
+void ligar(GLuint &ligado, GLuint novo)
+{
+	if (ligado == novo)
+		atual.bindsRedundantes++;
+	ligado = novo;
+}
+
+void APIENTRY observarBindVertexArray(GLuint vao)
+{
+	ligar(ligados.vao, vao);
+	// O GL_ELEMENT_ARRAY_BUFFER faz parte do estado do VAO
+	ligados.buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+}
+
+void APIENTRY observarUseProgram(GLuint programa) { ligar(ligados.programa, programa); }
+
+void APIENTRY observarActiveTexture(GLenum unidade) { ligados.unidade = unidade; }
+
+void APIENTRY observarBindTexture(GLenum alvo, GLuint textura)
+{
+	auto it = ligados.texturas.try_emplace(((uint64_t)ligados.unidade << 32) | alvo, 0).first;
+	ligar(it->second, textura);
+}
+
+void APIENTRY observarBindBuffer(GLenum alvo, GLuint buffer)
+{
+	auto it = ligados.buffers.try_emplace(alvo, 0).first;
+	ligar(it->second, buffer);
+}
+
+void APIENTRY observarBindBufferBase(GLenum alvo, GLuint indice, GLuint buffer)
+{
+	auto it = ligados.buffers.try_emplace(((uint64_t)indice << 32) | alvo, 0).first;
+	ligar(it->second, buffer);
+	ligados.buffers[alvo] = buffer;
+}
+
+void APIENTRY observarBindFramebuffer(GLenum alvo, GLuint fbo)
+{
+	if (alvo == GL_FRAMEBUFFER) {
+		GLuint &draw = ligados.framebuffers[GL_DRAW_FRAMEBUFFER];
+		GLuint &read = ligados.framebuffers[GL_READ_FRAMEBUFFER];
+		if (draw == fbo && read == fbo)
+			atual.bindsRedundantes++;
+		draw = read = fbo;
+	}
+	else
+		ligar(ligados.framebuffers[alvo], fbo);
+}
+
+// Objetos apagados deixam de estar ligados; como é raro, o cache todo é esquecido
+// (o próximo bind de cada alvo nunca conta como redundante)
+void esquecerLigados()
+{
+	ligados.texturas.clear();
+	ligados.buffers.clear();
+	ligados.framebuffers.clear();
+	ligados.vao = ligados.programa = ~0u;
+}
+void APIENTRY observarDelete(GLsizei, const GLuint *) { esquecerLigados(); }
+void APIENTRY observarDeleteProgram(GLuint) { esquecerLigados(); }
+
+size_t bytesTexels(GLsizei largura, GLsizei altura, GLsizei profundidade, GLenum formato, GLenum tipo)
+{
+	size_t componentes;
+	switch (formato) {
+	case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX: componentes = 1; break;
+	case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL: componentes = 2; break;
+	case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: componentes = 3; break;
+	default: componentes = 4; break;
+	}
+	size_t bytesComponente;
+	switch (tipo) {
+	case GL_UNSIGNED_BYTE: case GL_BYTE: bytesComponente = 1; break;
+	case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: bytesComponente = 2; break;
+	case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: bytesComponente = 4; break;
+	default: componentes = 1; bytesComponente = 4; break; // tipos empacotados (GL_UNSIGNED_INT_8_8_8_8, ...)
+	}
+	return (size_t)largura * altura * profundidade * componentes * bytesComponente;
+}
+
+void APIENTRY observarBufferData(GLenum, GLsizeiptr tamanho, const void *dados, GLenum)
+{
+	if (dados)
+		atual.bytesEnviados += tamanho;
+}
+
+void APIENTRY observarBufferSubData(GLenum, GLintptr, GLsizeiptr tamanho, const void *)
+{
+	atual.bytesEnviados += tamanho;
+}
+
+void APIENTRY observarTexImage2D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLint, GLenum formato, GLenum tipo,
+								 const void *dados)
+{
+	if (dados)
+		atual.bytesEnviados += bytesTexels(w, h, 1, formato, tipo);
+}
+
+void APIENTRY observarTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei w, GLsizei h, GLenum formato, GLenum tipo,
+									const void *)
+{
+	atual.bytesEnviados += bytesTexels(w, h, 1, formato, tipo);
+}
+
+void APIENTRY observarTexImage3D(GLenum, GLint, GLint, GLsizei w, GLsizei h, GLsizei d, GLint, GLenum formato,
+								 GLenum tipo, const void *dados)
+{
+	if (dados)
+		atual.bytesEnviados += bytesTexels(w, h, d, formato, tipo);
+}
+
+void APIENTRY observarTexSubImage3D(GLenum, GLint, GLint, GLint, GLint, GLsizei w, GLsizei h, GLsizei d, GLenum formato,
+									GLenum tipo, const void *)
+{
+	atual.bytesEnviados += bytesTexels(w, h, d, formato, tipo);
+}
+
+} // namespace
+
+// glad_##f: o nome do ponteiro, sem expandir a macro glDrawArrays -> glad_glDrawArrays
+#define INSTALAR(f, categoria) Gancho<&glad_##f>::instalar(CategoriaGL::categoria, #f)
+#define INSTALAR_COM(f, categoria, observador) \
+	Gancho<&glad_##f, &observador>::instalar(CategoriaGL::categoria, #f)
+
+void instalarInstrumentacaoGL(bool verificarErros)
+{
+	verificar = verificarErros;
+	getErrorOriginal = glad_glGetError;
+#ifdef NDEBUG
+	if (verificarErros)
+		std::cerr << "InstrumentacaoGL: verificação de erros só existe nos builds de debug" << std::endl;
+#endif
+
+	INSTALAR(glDrawArrays, Draw);
+	INSTALAR(glDrawElements, Draw);
+	INSTALAR(glDrawArraysInstanced, Draw);
+	INSTALAR(glDrawElementsInstanced, Draw);
+	INSTALAR(glDrawArraysIndirect, Draw);
+	INSTALAR(glMultiDrawArrays, Draw);
+	INSTALAR(glMultiDrawArraysIndirect, Draw);
+
+	INSTALAR_COM(glBindVertexArray, Bind, observarBindVertexArray);
+	INSTALAR_COM(glUseProgram, Bind, observarUseProgram);
+	INSTALAR_COM(glBindTexture, Bind, observarBindTexture);
+	INSTALAR_COM(glBindBuffer, Bind, observarBindBuffer);
+	INSTALAR_COM(glBindBufferBase, Bind, observarBindBufferBase);
+	INSTALAR_COM(glBindFramebuffer, Bind, observarBindFramebuffer);
+
+	INSTALAR(glUniform1i, Uniform);
+	INSTALAR(glUniform1ui, Uniform);
+	INSTALAR(glUniform1f, Uniform);
+	INSTALAR(glUniform2f, Uniform);
+	INSTALAR(glUniform3f, Uniform);
+	INSTALAR(glUniform4f, Uniform);
+	INSTALAR(glUniform2i, Uniform);
+	INSTALAR(glUniform1fv, Uniform);
+	INSTALAR(glUniform2fv, Uniform);
+	INSTALAR(glUniform3fv, Uniform);
+	INSTALAR(glUniform4fv, Uniform);
+	INSTALAR(glUniformMatrix3fv, Uniform);
+	INSTALAR(glUniformMatrix4fv, Uniform);
+
+	INSTALAR_COM(glBufferData, Upload, observarBufferData);
+	INSTALAR_COM(glBufferSubData, Upload, observarBufferSubData);
+	INSTALAR_COM(glTexImage2D, Upload, observarTexImage2D);
+	INSTALAR_COM(glTexSubImage2D, Upload, observarTexSubImage2D);
+	INSTALAR_COM(glTexImage3D, Upload, observarTexImage3D);
+	INSTALAR_COM(glTexSubImage3D, Upload, observarTexSubImage3D);
+
+	INSTALAR_COM(glActiveTexture, Estado, observarActiveTexture);
+	INSTALAR(glEnable, Estado);
+	INSTALAR(glDisable, Estado);
+	INSTALAR(glBlendFunc, Estado);
+	INSTALAR(glDepthFunc, Estado);
+	INSTALAR(glViewport, Estado);
+	INSTALAR(glClear, Estado);
+	INSTALAR(glClearColor, Estado);
+	INSTALAR(glLineWidth, Estado);
+	INSTALAR(glPointSize, Estado);
+	INSTALAR(glPolygonMode, Estado);
+	INSTALAR(glPixelStorei, Estado);
+	INSTALAR(glTexParameteri, Estado);
+
+	INSTALAR_COM(glDeleteTextures, Outra, observarDelete);
+	INSTALAR_COM(glDeleteBuffers, Outra, observarDelete);
+	INSTALAR_COM(glDeleteVertexArrays, Outra, observarDelete);
+	INSTALAR_COM(glDeleteFramebuffers, Outra, observarDelete);
+	INSTALAR_COM(glDeleteProgram, Outra, observarDeleteProgram);
+	INSTALAR(glGetUniformLocation, Outra);
+	INSTALAR(glVertexAttribPointer, Outra);
+	INSTALAR(glEnableVertexAttribArray, Outra);
+	INSTALAR(glGenerateMipmap, Outra);
+	INSTALAR(glMapBufferRange, Outra);
+	INSTALAR(glUnmapBuffer, Outra);
+	INSTALAR(glFenceSync, Outra);
+	INSTALAR(glClientWaitSync, Outra);
+	INSTALAR(glDeleteSync, Outra);
+}
+
+void fimDoFrameGL()
+{
+	ultimo = atual;
+	atual = ContadoresGL();
+}
+
+const ContadoresGL &contadoresGL() { return ultimo; }
+
+void imprimirContadoresGL(std::ostream &saida)
+{
+	char linha[256];
+	snprintf(linha, sizeof(linha),
+			 "GL: %u chamadas, %u draws, %u binds (%u redundantes), %u uniforms, %u estado, "
+			 "%u uploads (%.1f KiB), %u erros",
+			 ultimo.chamadas, ultimo.draws, ultimo.binds, ultimo.bindsRedundantes, ultimo.uniforms, ultimo.estado,
+			 ultimo.uploads, ultimo.bytesEnviados / 1024.0, ultimo.erros);
+	saida << linha << std::endl;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+// Contagem das chamadas OpenGL de cada frame. instalarInstrumentacaoGL() troca os
+// ponteiros de função da GLAD (glad_glDrawArrays, ...) por versões que contam a
+// chamada e depois chamam a original, então o código dos exercícios não muda.
+// São instrumentadas as funções usadas no desenho (draws, binds, uniforms, envio de
+// dados e estado); as demais continuam diretas e não entram na contagem.
+//
+// Só existe quando a engine é compilada com -DPG_INSTRUMENTAR_GL=ON, e nunca nos
+// builds Release. Sem ela as funções abaixo são vazias e INSTRUMENTACAO_GL é false.
+//
+//   gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+//   instalarInstrumentacaoGL(true);      // true: glGetError depois de cada chamada
+//   ...
+//   glfwSwapBuffers(window);
+//   fimDoFrameGL();
+//   imprimirContadoresGL(cout);          // contadores do frame que acabou
+//
+// Bind redundante é o de um objeto que já estava ligado no mesmo alvo (e na mesma
+// unidade de textura): não muda nada no driver e pode ser evitado. A verificação de
+// erros (só em builds de debug) consome o glGetError da aplicação.
+struct ContadoresGL {
+	uint32_t chamadas = 0;         // todas as funções instrumentadas
+	uint32_t draws = 0;
+	uint32_t binds = 0;            // VAO, textura, buffer, programa, framebuffer
+	uint32_t bindsRedundantes = 0;
+	uint32_t uniforms = 0;
+	uint32_t estado = 0;           // enable/disable, blend, viewport, clear, ...
+	uint32_t uploads = 0;          // glBufferData/SubData, glTexImage/SubImage
+	uint64_t bytesEnviados = 0;
+	uint32_t erros = 0;
+};
+
+#ifdef PG_INSTRUMENTAR_GL
+
+constexpr bool INSTRUMENTACAO_GL = true;
+
+// Chamar depois de gladLoadGLLoader, com o contexto atual
+void instalarInstrumentacaoGL(bool verificarErros = false);
+
+// Fecha o frame: os contadores do frame atual passam a valer para contadoresGL()
+void fimDoFrameGL();
+
+// Contadores do último frame fechado
+const ContadoresGL &contadoresGL();
+
+void imprimirContadoresGL(std::ostream &saida);
+
+#else
+
+constexpr bool INSTRUMENTACAO_GL = false;
+
+inline void instalarInstrumentacaoGL(bool = false) {}
+inline void fimDoFrameGL() {}
+inline const ContadoresGL &contadoresGL()
+{
+	static const ContadoresGL zerados;
+	return zerados;
+}
+inline void imprimirContadoresGL(std::ostream &) {}
+
+#endif
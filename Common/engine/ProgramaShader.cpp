@@ -0,0 +1,250 @@
+#include "ProgramaShader.h"
+#include "ConstantesFrame.h"
+#include "Shader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+static bool lerArquivo(const std::string &arquivo, std::string &conteudo)
+{
+	std::ifstream f(arquivo, std::ios::binary);
+	if (!f)
+		return false;
+	std::stringstream ss;
+	ss << f.rdbuf();
+	conteudo = ss.str();
+	return true;
+}
+
+// FNV-1a de 64 bits
+static uint64_t hash(const std::string &s, uint64_t h = 1469598103934665603ull)
+{
+	for (unsigned char c : s)
+	{
+		h ^= c;
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+static std::string textoGL(GLenum nome)
+{
+	const GLubyte *s = glGetString(nome);
+	return s ? (const char *)s : "";
+}
+
+static std::string arquivoCache(const std::string &vs, const std::string &fs)
+{
+	uint64_t h = hash(vs);
+	h = hash(std::string(1, '\0') + fs, h);
+	h = hash(textoGL(GL_VENDOR) + '\n' + textoGL(GL_RENDERER) + '\n' + textoGL(GL_VERSION), h);
+	char nome[32];
+	snprintf(nome, sizeof(nome), "%016llx.bin", (unsigned long long)h);
+	return ProgramaShader::diretorioCache() + "/" + nome;
+}
+
+static bool binarioSuportado()
+{
+	if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary)
+		return false;
+	GLint formatos = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatos);
+	return formatos > 0;
+}
+
+// Arquivo: formato (uint32) + binário. Um binário rejeitado pelo driver (ou
+// corrompido) só faz o programa ser compilado de novo.
+static GLuint carregarBinario(const std::string &cache)
+{
+	std::string dados;
+	if (!binarioSuportado() || !lerArquivo(cache, dados) || dados.size() <= sizeof(uint32_t))
+		return 0;
+
+	uint32_t formato;
+	memcpy(&formato, dados.data(), sizeof(formato));
+	GLuint prog = glCreateProgram();
+	glProgramBinary(prog, formato, dados.data() + sizeof(formato), (GLsizei)(dados.size() - sizeof(formato)));
+
+	GLint success;
+	glGetProgramiv(prog, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(prog);
+		return 0;
+	}
+	return prog;
+}
+
+static void salvarBinario(GLuint prog, const std::string &cache)
+{
+	if (!binarioSuportado())
+		return;
+	GLint tamanho = 0;
+	glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &tamanho);
+	if (tamanho <= 0)
+		return;
+
+	std::vector<char> dados(sizeof(uint32_t) + tamanho);
+	GLenum formato;
+	glGetProgramBinary(prog, tamanho, nullptr, &formato, dados.data() + sizeof(uint32_t));
+	uint32_t f32 = formato;
+	memcpy(dados.data(), &f32, sizeof(f32));
+
+	std::error_code erro;
+	std::filesystem::create_directories(ProgramaShader::diretorioCache(), erro);
+	std::ofstream f(cache, std::ios::binary);
+	if (f)
+		f.write(dados.data(), dados.size());
+}
+
+ProgramaShader::~ProgramaShader()
+{
+#ifdef __linux__
+	if (fdInotify >= 0)
+		close(fdInotify);
+#endif
+}
+
+std::string &ProgramaShader::diretorioCache()
+{
+	static std::string dir = "shader_cache";
+	return dir;
+}
+
+bool ProgramaShader::carregar(const std::string &arquivoVertex, const std::string &arquivoFragment)
+{
+	arquivos[0] = arquivoVertex;
+	arquivos[1] = arquivoFragment;
+	caminhos[0] = arquivoVertex;
+	caminhos[1] = arquivoFragment;
+	observar();
+	return construir();
+}
+
+bool ProgramaShader::recarregarSeMudou()
+{
+	if (!arquivosMudaram())
+		return false;
+	GLuint anterior = programa;
+	if (!construir() || programa == anterior)
+		return false;
+	std::cout << "Shader recarregado: " << arquivos[0] << " + " << arquivos[1] << std::endl;
+	return true;
+}
+
+bool ProgramaShader::construir()
+{
+	auto inicio = std::chrono::steady_clock::now();
+
+	std::string fontes[2];
+	for (int k = 0; k < 2; k++)
+	{
+		if (!lerArquivo(arquivos[k], fontes[k]))
+		{
+			std::cout << "ERROR::SHADER::FILE_NOT_READ " << arquivos[k] << std::endl;
+			return false;
+		}
+	}
+
+	std::string cache = arquivoCache(fontes[0], fontes[1]);
+	bool doCache = true;
+	GLuint novo = carregarBinario(cache);
+	if (!novo)
+	{
+		doCache = false;
+		novo = setupShader(fontes[0].c_str(), fontes[1].c_str(), true);
+		if (!novo)
+			return false;
+		salvarBinario(novo, cache);
+	}
+
+	// A ligação dos blocos de uniforms não vem no binário do cache
+	if (doCache)
+		ligarConstantesFrame(novo);
+
+	if (programa)
+		glDeleteProgram(programa);
+	programa = novo;
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+	std::cout << "Shader " << arquivos[0] << (doCache ? " carregado do cache" : " compilado") << " em " << ms << " ms" << std::endl;
+	return true;
+}
+
+void ProgramaShader::observar()
+{
+	for (int k = 0; k < 2; k++)
+	{
+		std::error_code erro;
+		datas[k] = std::filesystem::last_write_time(caminhos[k], erro);
+	}
+	ultimaConsulta = std::chrono::steady_clock::now();
+
+#ifdef __linux__
+	if (fdInotify >= 0)
+		close(fdInotify);
+	fdInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fdInotify < 0)
+		return;
+	// Observa os diretórios, não os arquivos: editores costumam salvar gravando um
+	// arquivo temporário e renomeando por cima do original
+	for (int k = 0; k < 2; k++)
+	{
+		std::filesystem::path dir = std::filesystem::path(arquivos[k]).parent_path();
+		inotify_add_watch(fdInotify, dir.empty() ? "." : dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	}
+#endif
+}
+
+bool ProgramaShader::arquivosMudaram()
+{
+#ifdef __linux__
+	if (fdInotify >= 0)
+	{
+		bool mudou = false;
+		alignas(inotify_event) char buffer[4096];
+		ssize_t n;
+		while ((n = read(fdInotify, buffer, sizeof(buffer))) > 0)
+		{
+			for (char *p = buffer; p < buffer + n;)
+			{
+				const inotify_event *e = (const inotify_event *)p;
+				if (e->len > 0)
+				{
+					for (int k = 0; k < 2; k++)
+						if (std::filesystem::path(arquivos[k]).filename() == e->name)
+							mudou = true;
+				}
+				p += sizeof(inotify_event) + e->len;
+			}
+		}
+		return mudou;
+	}
+#endif
+	auto agora = std::chrono::steady_clock::now();
+	if (agora - ultimaConsulta < std::chrono::milliseconds(500))
+		return false;
+	ultimaConsulta = agora;
+
+	bool mudou = false;
+	for (int k = 0; k < 2; k++)
+	{
+		std::error_code erro;
+		auto data = std::filesystem::last_write_time(caminhos[k], erro);
+		if (!erro && data != datas[k])
+		{
+			datas[k] = data;
+			mudou = true;
+		}
+	}
+	return mudou;
+}
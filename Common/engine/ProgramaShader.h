@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <glad/glad.h>
+
+// Programa de shader lido de arquivos (vertex + fragment), com recarga a quente e
+// cache do programa linkado em disco.
+//
+// - Recarga: no Linux os diretórios dos arquivos são observados com inotify (sem
+//   custo enquanto nada muda); nos outros sistemas a data de modificação é
+//   consultada a cada meio segundo. Se a nova versão não compilar, o erro vai para
+//   o terminal e o programa antigo continua em uso.
+// - Cache: o binário do programa (glGetProgramBinary) é salvo em
+//   diretorioCache/<hash>.bin, com o hash calculado sobre os fontes e sobre
+//   vendor/renderer/versão do driver; na próxima execução, com os mesmos fontes e o
+//   mesmo driver, o programa é carregado com glProgramBinary sem compilar nada.
+//
+//   ProgramaShader shader;
+//   shader.carregar("../shaders/Desafio/sprite.vert", "../shaders/Desafio/sprite.frag");
+//   ...
+//   if (shader.recarregarSeMudou())   // a cada frame; true = id() mudou
+//       configurarUniforms(shader.id());
+class ProgramaShader {
+public:
+	ProgramaShader() = default;
+	ProgramaShader(const ProgramaShader &) = delete;
+	ProgramaShader &operator=(const ProgramaShader &) = delete;
+	~ProgramaShader();
+
+	static std::string &diretorioCache();
+
+	bool carregar(const std::string &arquivoVertex, const std::string &arquivoFragment);
+
+	GLuint id() const { return programa; }
+
+	// Barato quando nada mudou: uma leitura não bloqueante do inotify (ou uma consulta
+	// de data a cada 0,5 s). Retorna true se um programa novo substituiu o anterior.
+	bool recarregarSeMudou();
+
+private:
+	bool construir();
+	void observar();
+	bool arquivosMudaram();
+
+	GLuint programa = 0;
+	std::string arquivos[2];
+	std::filesystem::path caminhos[2]; // os mesmos arquivos, para a consulta periódica não montar paths
+	std::filesystem::file_time_type datas[2];
+	std::chrono::steady_clock::time_point ultimaConsulta;
+	int fdInotify = -1;
+};
@@ -0,0 +1,328 @@
+#include "RasterizadorCPU.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <stb_image.h>
+
+// A implementação da stb_image_write fica só aqui (a imagem é um repositório inteiro
+// da stb, baixado pelo FetchContent)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTERIZADOR_SSE2 1
+#endif
+
+static const int TAM_BLOCO = 64;
+
+// Mistura src sobre dst (SRC_ALPHA, ONE_MINUS_SRC_ALPHA) nos quatro canais:
+// round((s * a + d * (255 - a)) / 255), com a divisão por 255 exata em inteiros
+static inline uint32_t misturar(uint32_t s, uint32_t d)
+{
+	uint32_t a = s >> 24;
+	if (a == 255)
+		return s;
+	if (a == 0)
+		return d;
+	uint32_t r = 0;
+	for (int c = 0; c < 32; c += 8)
+	{
+		uint32_t x = ((s >> c) & 255) * a + ((d >> c) & 255) * (255 - a) + 128;
+		r |= ((x + (x >> 8)) >> 8) << c;
+	}
+	return r;
+}
+
+#ifdef RASTERIZADOR_SSE2
+// A mesma conta para 2 pixels em 8 canais de 16 bits (s * a + d * (255 - a) + 128
+// cabe em 16 bits sem sinal)
+static inline __m128i misturar2(__m128i s, __m128i d)
+{
+	const __m128i c255 = _mm_set1_epi16(255), c128 = _mm_set1_epi16(128);
+	__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	__m128i x = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(c255, a))), c128);
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline void misturar4(uint32_t *dst, const uint32_t *src)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i s = _mm_loadu_si128((const __m128i *)src);
+	__m128i d = _mm_loadu_si128((const __m128i *)dst);
+	__m128i lo = misturar2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+	__m128i hi = misturar2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+	_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+}
+#else
+static inline void misturar4(uint32_t *dst, const uint32_t *src)
+{
+	for (int k = 0; k < 4; k++)
+		dst[k] = misturar(src[k], dst[k]);
+}
+#endif
+
+// Índice de texel com GL_REPEAT e GL_NEAREST
+static inline int texelRepetido(float coord, int tamanho)
+{
+	int i = (int)std::floor(coord * tamanho) % tamanho;
+	return i < 0 ? i + tamanho : i;
+}
+
+RasterizadorCPU::RasterizadorCPU(int largura, int altura, int nThreads)
+	: larguraFB(largura), alturaFB(altura)
+{
+	blocosX = (largura + TAM_BLOCO - 1) / TAM_BLOCO;
+	blocosY = (altura + TAM_BLOCO - 1) / TAM_BLOCO;
+	framebuffer.assign((size_t)largura * altura, 0);
+	inicioBloco.resize((size_t)blocosX * blocosY + 1);
+	cursorBloco.resize((size_t)blocosX * blocosY);
+
+	if (nThreads <= 0)
+		nThreads = std::max(1u, std::thread::hardware_concurrency());
+	// A thread que chama finalizarFrame() também rasteriza
+	for (int i = 1; i < nThreads; i++)
+		threads.emplace_back(&RasterizadorCPU::trabalhador, this);
+}
+
+RasterizadorCPU::~RasterizadorCPU()
+{
+	{
+		std::lock_guard<std::mutex> trava(mutex);
+		encerrar = true;
+	}
+	cvInicio.notify_all();
+	for (std::thread &t : threads)
+		t.join();
+}
+
+GLuint RasterizadorCPU::adicionarTextura(const unsigned char *rgba, int largura, int altura)
+{
+	Textura t;
+	t.largura = largura;
+	t.altura = altura;
+	t.texels.resize((size_t)largura * altura);
+	memcpy(t.texels.data(), rgba, t.texels.size() * 4);
+	texturas.push_back(std::move(t));
+	return (GLuint)texturas.size();
+}
+
+GLuint RasterizadorCPU::carregarTextura(const std::string &arquivo)
+{
+	int largura, altura, canais;
+	unsigned char *dados = stbi_load(arquivo.c_str(), &largura, &altura, &canais, STBI_rgb_alpha);
+	if (!dados)
+	{
+		std::cout << "Falha ao carregar textura: " << arquivo << std::endl;
+		return 0;
+	}
+	GLuint id = adicionarTextura(dados, largura, altura);
+	stbi_image_free(dados);
+	return id;
+}
+
+void RasterizadorCPU::limpar(float r, float g, float b, float a)
+{
+	auto canal = [](float v) { return (uint32_t)std::lround(std::min(std::max(v, 0.0f), 1.0f) * 255.0f); };
+	corLimpeza = canal(r) | canal(g) << 8 | canal(b) << 16 | canal(a) << 24;
+	limparNoFrame = true;
+}
+
+void RasterizadorCPU::projecao(const glm::mat4 &projection)
+{
+	projectionAtual = projection;
+}
+
+void RasterizadorCPU::desenhar(const QuadTexturizado &quad)
+{
+	if (!quad.vertices || quad.textura == 0 || quad.textura > texturas.size())
+		return;
+
+	// V0, V1 e V2 na tela (linha 0 no topo) e as coordenadas de textura do shader
+	glm::mat4 mvp = projectionAtual * quad.model;
+	float px[3], py[3], s[3], t[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const GLfloat *v = quad.vertices + i * 5;
+		glm::vec4 clip = mvp * glm::vec4(v[0], v[1], v[2], 1.0f);
+		px[i] = (clip.x / clip.w * 0.5f + 0.5f) * larguraFB;
+		py[i] = (0.5f - clip.y / clip.w * 0.5f) * alturaFB;
+		s[i] = v[3] + quad.offsetTex.x;
+		t[i] = (inverterT ? 1.0f - v[4] : v[4]) + quad.offsetTex.y;
+	}
+
+	float e1x = px[1] - px[0], e1y = py[1] - py[0];
+	float e2x = px[2] - px[0], e2y = py[2] - py[0];
+	float det = e1x * e2y - e1y * e2x;
+	if (std::fabs(det) < 1e-8f)
+		return;
+
+	QuadPreparado q;
+	q.textura = quad.textura - 1;
+	q.ox = px[0];
+	q.oy = py[0];
+	q.ax = e2y / det;
+	q.ay = -e2x / det;
+	q.bx = -e1y / det;
+	q.by = e1x / det;
+	q.s0 = s[0];
+	q.t0 = t[0];
+	q.sa = s[1] - s[0];
+	q.ta = t[1] - t[0];
+	q.sb = s[2] - s[0];
+	q.tb = t[2] - t[0];
+
+	// Caixa dos pixels cujo centro pode cair no paralelogramo (V3 = V1 + V2 - V0)
+	float xs[4] = {px[0], px[1], px[2], px[1] + px[2] - px[0]};
+	float ys[4] = {py[0], py[1], py[2], py[1] + py[2] - py[0]};
+	q.x0 = std::max(0, (int)std::ceil(*std::min_element(xs, xs + 4) - 0.5f));
+	q.x1 = std::min(larguraFB, (int)std::floor(*std::max_element(xs, xs + 4) - 0.5f) + 1);
+	q.y0 = std::max(0, (int)std::ceil(*std::min_element(ys, ys + 4) - 0.5f));
+	q.y1 = std::min(alturaFB, (int)std::floor(*std::max_element(ys, ys + 4) - 0.5f) + 1);
+	if (q.x0 >= q.x1 || q.y0 >= q.y1)
+		return;
+
+	quads.push_back(q);
+}
+
+void RasterizadorCPU::finalizarFrame()
+{
+	// Quads de cada bloco num array só, em dois passos (contagem e preenchimento), na
+	// ordem de envio. O array só cresce num frame com mais pares quad/bloco que todos
+	// os anteriores, então frames parecidos não alocam.
+	std::fill(inicioBloco.begin(), inicioBloco.end(), 0);
+	for (const QuadPreparado &q : quads)
+		for (int by = q.y0 / TAM_BLOCO; by <= (q.y1 - 1) / TAM_BLOCO; by++)
+			for (int bx = q.x0 / TAM_BLOCO; bx <= (q.x1 - 1) / TAM_BLOCO; bx++)
+				inicioBloco[by * blocosX + bx + 1]++;
+	for (size_t b = 1; b < inicioBloco.size(); b++)
+		inicioBloco[b] += inicioBloco[b - 1];
+	if (quadsPorBloco.size() < inicioBloco.back())
+		quadsPorBloco.resize(inicioBloco.back() + inicioBloco.back() / 2);
+
+	std::copy(inicioBloco.begin(), inicioBloco.end() - 1, cursorBloco.begin());
+	for (uint32_t i = 0; i < quads.size(); i++)
+	{
+		const QuadPreparado &q = quads[i];
+		for (int by = q.y0 / TAM_BLOCO; by <= (q.y1 - 1) / TAM_BLOCO; by++)
+			for (int bx = q.x0 / TAM_BLOCO; bx <= (q.x1 - 1) / TAM_BLOCO; bx++)
+				quadsPorBloco[cursorBloco[by * blocosX + bx]++] = i;
+	}
+
+	proximoBloco = 0;
+	if (threads.empty())
+	{
+		rasterizarBlocos();
+	}
+	else
+	{
+		{
+			std::lock_guard<std::mutex> trava(mutex);
+			ativas = (int)threads.size();
+			geracao++;
+		}
+		cvInicio.notify_all();
+		rasterizarBlocos();
+
+		std::unique_lock<std::mutex> trava(mutex);
+		cvFim.wait(trava, [this] { return ativas == 0; });
+	}
+
+	quads.clear();
+	limparNoFrame = false;
+}
+
+void RasterizadorCPU::trabalhador()
+{
+	uint64_t vista = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> trava(mutex);
+			cvInicio.wait(trava, [&] { return encerrar || geracao != vista; });
+			if (encerrar)
+				return;
+			vista = geracao;
+		}
+
+		rasterizarBlocos();
+
+		std::lock_guard<std::mutex> trava(mutex);
+		if (--ativas == 0)
+			cvFim.notify_one();
+	}
+}
+
+void RasterizadorCPU::rasterizarBlocos()
+{
+	int total = blocosX * blocosY;
+	for (int b = proximoBloco++; b < total; b = proximoBloco++)
+		rasterizarBloco(b);
+}
+
+void RasterizadorCPU::rasterizarBloco(int bloco)
+{
+	int bx0 = (bloco % blocosX) * TAM_BLOCO, by0 = (bloco / blocosX) * TAM_BLOCO;
+	int bx1 = std::min(bx0 + TAM_BLOCO, larguraFB), by1 = std::min(by0 + TAM_BLOCO, alturaFB);
+
+	if (limparNoFrame)
+		for (int y = by0; y < by1; y++)
+			std::fill(&framebuffer[(size_t)y * larguraFB + bx0], &framebuffer[(size_t)y * larguraFB + bx1], corLimpeza);
+
+	for (uint32_t k = inicioBloco[bloco]; k < inicioBloco[bloco + 1]; k++)
+		rasterizar(quads[quadsPorBloco[k]], bx0, by0, bx1, by1);
+}
+
+void RasterizadorCPU::rasterizar(const QuadPreparado &q, int bx0, int by0, int bx1, int by1)
+{
+	const Textura &tex = texturas[q.textura];
+	int xIni = std::max(bx0, q.x0), xFim = std::min(bx1, q.x1);
+	int yIni = std::max(by0, q.y0), yFim = std::min(by1, q.y1);
+
+	for (int y = yIni; y < yFim; y++)
+	{
+		float dy = y + 0.5f - q.oy;
+		float dx = xIni + 0.5f - q.ox;
+		float a = q.ax * dx + q.ay * dy;
+		float b = q.bx * dx + q.by * dy;
+		uint32_t *linha = &framebuffer[(size_t)y * larguraFB];
+
+		for (int x = xIni; x < xFim; x += 4)
+		{
+			int n = std::min(4, xFim - x);
+			uint32_t src[4] = {0, 0, 0, 0};
+			bool algum = false;
+			for (int k = 0; k < n; k++, a += q.ax, b += q.bx)
+			{
+				if (a < 0.0f || a >= 1.0f || b < 0.0f || b >= 1.0f)
+					continue;
+				float s = q.s0 + a * q.sa + b * q.sb;
+				float t = q.t0 + a * q.ta + b * q.tb;
+				src[k] = tex.texels[(size_t)texelRepetido(t, tex.altura) * tex.largura + texelRepetido(s, tex.largura)];
+				algum |= (src[k] >> 24) != 0;
+			}
+			if (!algum)
+				continue;
+
+			// Fora do quad o texel fica 0 (alfa 0), que mantém o destino
+			if (n == 4)
+				misturar4(linha + x, src);
+			else
+				for (int k = 0; k < n; k++)
+					linha[x + k] = misturar(src[k], linha[x + k]);
+		}
+	}
+}
+
+bool RasterizadorCPU::salvarPNG(const std::string &arquivo) const
+{
+	if (!stbi_write_png(arquivo.c_str(), larguraFB, alturaFB, 4, framebuffer.data(), larguraFB * 4))
+	{
+		std::cout << "Falha ao gravar " << arquivo << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Renderizador.h"
+
+// Backend de CPU do Renderizador: rasteriza os quads texturizados num framebuffer
+// RGBA8 em memória, sem contexto OpenGL (máquinas de build/CI sem GPU, testes de
+// imagem). Segue as regras do pipeline dos exercícios para servir de referência
+// para a saída da GPU:
+//
+// - pixel coberto quando o centro dele está dentro do quad (o quad é o
+//   paralelogramo de V0, V1 e V2; V3 = V1 + V2 - V0, como nos quads de setupSprite,
+//   setupTile e SpriteSheet);
+// - coordenada de textura como no vertex shader, tex_coord = (s, 1 - t) + offsetTex
+//   (inverterT = false usa (s, t) + offsetTex), com GL_NEAREST e GL_REPEAT;
+// - glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) nos quatro canais, em 8 bits
+//   com arredondamento, 4 pixels por vez com SSE2 quando disponível.
+//
+// desenhar() só enfileira; finalizarFrame() divide a tela em blocos de 64x64 pixels,
+// distribui os quads pelos blocos que eles tocam e rasteriza os blocos em paralelo.
+// Dentro de um bloco os quads são desenhados na ordem de envio, então o resultado
+// não depende do número de threads.
+//
+//   RasterizadorCPU cpu(800, 600);
+//   GLuint tex = cpu.carregarTextura("../assets/tilesets/tilesetIso.png");
+//   cpu.limpar(0, 0, 0, 1);
+//   cpu.projecao(projection);
+//   cpu.desenhar(quad);            // quad.textura = tex, quad.vertices = verticesTile(n)
+//   cpu.finalizarFrame();
+//   cpu.salvarPNG("frame.png");
+class RasterizadorCPU : public Renderizador {
+public:
+	// nThreads = 0: uma por núcleo
+	RasterizadorCPU(int largura, int altura, int nThreads = 0);
+	~RasterizadorCPU() override;
+	RasterizadorCPU(const RasterizadorCPU &) = delete;
+	RasterizadorCPU &operator=(const RasterizadorCPU &) = delete;
+
+	// Texturas do rasterizador (os ids só valem aqui, começando em 1; 0 = erro)
+	GLuint adicionarTextura(const unsigned char *rgba, int largura, int altura);
+	GLuint carregarTextura(const std::string &arquivo);
+
+	bool inverterT = true;
+
+	void limpar(float r, float g, float b, float a);
+	void projecao(const glm::mat4 &projection) override;
+	void desenhar(const QuadTexturizado &quad) override;
+	void finalizarFrame();
+
+	int largura() const { return larguraFB; }
+	int altura() const { return alturaFB; }
+	// Pixels RGBA8, linha 0 = topo da tela
+	const std::vector<uint32_t> &pixels() const { return framebuffer; }
+	bool salvarPNG(const std::string &arquivo) const;
+
+private:
+	struct Textura {
+		int largura = 0, altura = 0;
+		std::vector<uint32_t> texels;
+	};
+
+	// Quad já em pixels: p = origem + a * e1 + b * e2 com a, b em [0, 1)
+	struct QuadPreparado {
+		uint32_t textura;         // índice em texturas
+		float ox, oy;             // V0 na tela
+		float ax, ay, bx, by;     // a = ax * dx + ay * dy, b = bx * dx + by * dy (d = p - V0)
+		float s0, t0, sa, ta, sb, tb; // coordenada de textura em V0 e derivadas em a e b
+		int x0, y0, x1, y1;       // caixa na tela, [x0, x1) x [y0, y1)
+	};
+
+	void rasterizarBlocos();
+	void rasterizarBloco(int bloco);
+	void rasterizar(const QuadPreparado &q, int bx0, int by0, int bx1, int by1);
+	void trabalhador();
+
+	int larguraFB, alturaFB;
+	int blocosX, blocosY;
+	std::vector<uint32_t> framebuffer;
+	std::vector<Textura> texturas;
+	glm::mat4 projectionAtual = glm::mat4(1.0f);
+
+	std::vector<QuadPreparado> quads;
+	// Quads do bloco b: quadsPorBloco[inicioBloco[b] .. inicioBloco[b + 1])
+	std::vector<uint32_t> quadsPorBloco, inicioBloco, cursorBloco;
+	bool limparNoFrame = false;
+	uint32_t corLimpeza = 0;
+
+	// Threads fixas: cada frame acorda todas, que pegam blocos de um contador atômico
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable cvInicio, cvFim;
+	uint64_t geracao = 0;
+	int ativas = 0;
+	bool encerrar = false;
+	std::atomic<int> proximoBloco{0};
+};
@@ -0,0 +1,99 @@
+#include "Renderizador.h"
+
+// O que o sprite.vert lê de cada quad: três texels RGBA32F com a transformação afim
+// 2D da model (colunas x e y e a translação), o deslocamento da textura e a camada
+struct DadosQuadGPU {
+	float eixoX[2], eixoY[2];
+	float translacao[2];
+	float offsetTex[2];
+	float camada, reservado[3];
+};
+
+void RenderizadorGL::iniciar()
+{
+	dadosQuads.init(4096 * sizeof(DadosQuadGPU));
+	glGenTextures(1, &texturaQuads);
+}
+
+void RenderizadorGL::usarPrograma(GLuint novo)
+{
+	if (novo == programa)
+		return;
+	programa = novo;
+	locPrimeiroQuad = glGetUniformLocation(programa, "primeiroQuad");
+	glUniform1i(glGetUniformLocation(programa, "quads"), UNIDADE_QUADS);
+	glUniform1i(glGetUniformLocation(programa, "camadas"), UNIDADE_CAMADAS);
+}
+
+static bool mesmoDesenho(const QuadTexturizado &a, const QuadTexturizado &b)
+{
+	return a.vao == b.vao && a.textura == b.textura && a.primeiroVertice == b.primeiroVertice &&
+		   (a.camada >= 0) == (b.camada >= 0);
+}
+
+void RenderizadorGL::desenharLote(const QuadTexturizado *quads, size_t n)
+{
+	if (n == 0)
+		return;
+	if (!texturaQuads)
+		iniciar();
+
+	GLintptr deslocamento;
+	DadosQuadGPU *dst = static_cast<DadosQuadGPU *>(dadosQuads.reservar(n * sizeof(DadosQuadGPU), deslocamento, sizeof(DadosQuadGPU)));
+	for (size_t k = 0; k < n; k++)
+	{
+		const glm::mat4 &m = quads[k].model;
+		DadosQuadGPU &d = dst[k];
+		d.eixoX[0] = m[0].x;
+		d.eixoX[1] = m[0].y;
+		d.eixoY[0] = m[1].x;
+		d.eixoY[1] = m[1].y;
+		d.translacao[0] = m[3].x;
+		d.translacao[1] = m[3].y;
+		d.offsetTex[0] = quads[k].offsetTex.x;
+		d.offsetTex[1] = quads[k].offsetTex.y;
+		d.camada = (float)quads[k].camada;
+	}
+	dadosQuads.confirmar();
+
+	glActiveTexture(GL_TEXTURE0 + UNIDADE_QUADS);
+	glBindTexture(GL_TEXTURE_BUFFER, texturaQuads);
+	// O armazenamento muda quando o streaming cresce, mesmo que o nome se repita
+	if (geracaoLigada != dadosQuads.geracao())
+	{
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, dadosQuads.buffer());
+		geracaoLigada = dadosQuads.geracao();
+	}
+	glActiveTexture(GL_TEXTURE0);
+
+	// Um draw instanciado por sequência de quads iguais (com a textura array, todos
+	// os tiles, qualquer que seja o tile); VAO e textura só são ligados quando mudam
+	GLint primeiro = (GLint)(deslocamento / sizeof(DadosQuadGPU));
+	GLuint texturaLigada[2] = {0, 0}; // 2D, array
+	size_t inicio = 0;
+	for (size_t k = 1; k <= n; k++)
+	{
+		if (k < n && mesmoDesenho(quads[k], quads[inicio]))
+			continue;
+
+		const QuadTexturizado &quad = quads[inicio];
+		if (inicio == 0 || quad.vao != quads[inicio - 1].vao)
+			glBindVertexArray(quad.vao);
+		int tipo = quad.camada >= 0;
+		if (quad.textura != texturaLigada[tipo])
+		{
+			if (tipo)
+			{
+				glActiveTexture(GL_TEXTURE0 + UNIDADE_CAMADAS);
+				glBindTexture(GL_TEXTURE_2D_ARRAY, quad.textura);
+				glActiveTexture(GL_TEXTURE0);
+			}
+			else
+				glBindTexture(GL_TEXTURE_2D, quad.textura);
+			texturaLigada[tipo] = quad.textura;
+		}
+		glUniform1i(locPrimeiroQuad, primeiro + (GLint)inicio);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, quad.primeiroVertice, 4, (GLsizei)(k - inicio));
+		inicio = k;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "BufferStreaming.h"
+
+// Um quad texturizado como os desenhados pelos exercícios: 4 vértices (x, y, z, s, t)
+// em GL_TRIANGLE_STRIP, matriz model (uma transformação 2D: o OpenGL só envia as
+// colunas x, y e a translação) e deslocamento da coordenada de textura. O mesmo quad
+// descrito para os dois backends: o OpenGL usa o VAO, o de CPU lê os vértices da
+// memória. Com camada >= 0 a textura é uma GL_TEXTURE_2D_ARRAY (loadTextureArray)
+// e o quad mostra essa camada; só o RenderizadorGL usa.
+struct QuadTexturizado {
+	GLuint vao = 0;
+	GLint primeiroVertice = 0;
+	const GLfloat *vertices = nullptr; // os 4 vértices que estão no VAO a partir de primeiroVertice
+	GLuint textura = 0;
+	glm::mat4 model = glm::mat4(1.0f);
+	glm::vec2 offsetTex = glm::vec2(0.0f);
+	int camada = -1;
+};
+
+// Destino do desenho de tiles e sprites: OpenGL (RenderizadorGL) ou rasterização em
+// software (RasterizadorCPU), para rodar sem GPU
+class Renderizador {
+public:
+	virtual ~Renderizador() = default;
+
+	// projection * view (o RenderizadorGL usa as do ConstantesFrame)
+	virtual void projecao(const glm::mat4 &projection) = 0;
+	virtual void desenhar(const QuadTexturizado &quad) = 0;
+
+	// n quads em sequência (comandos montados na ArenaFrame, por exemplo)
+	virtual void desenharLote(const QuadTexturizado *quads, size_t n)
+	{
+		for (size_t k = 0; k < n; k++)
+			desenhar(quads[k]);
+	}
+};
+
+// Backend OpenGL para os shaders de sprite (shaders/Desafio/sprite.*): projection e
+// view vêm do bloco ConstantesFrame, e a transformação, o deslocamento de textura e
+// a camada de cada quad, de um texture buffer ("quads") indexado por primeiroQuad +
+// gl_InstanceID. Texturas 2D ficam na unidade 0 ("tex_buff"), arrays na
+// UNIDADE_CAMADAS ("camadas"). Num lote, quads seguidos com o mesmo VAO, textura e primeiro
+// vértice saem numa única chamada instanciada, sem uniforms por quad.
+// O programa precisa estar em uso (glUseProgram).
+class RenderizadorGL : public Renderizador {
+public:
+	// Unidade de textura do texture buffer com os dados dos quads
+	static constexpr int UNIDADE_QUADS = 2;
+	static constexpr int UNIDADE_CAMADAS = 3;
+
+	// Busca as locations dos uniforms só quando o programa muda (recarga de shader)
+	void usarPrograma(GLuint programa);
+
+	// projection * view vão no ConstantesFrame, enviado uma vez por frame
+	void projecao(const glm::mat4 &) override {}
+	void desenhar(const QuadTexturizado &quad) override { desenharLote(&quad, 1); }
+	void desenharLote(const QuadTexturizado *quads, size_t n) override;
+
+	// Depois do glfwSwapBuffers: fecha o frame do buffer de streaming dos quads
+	void fimDoFrame() { dadosQuads.fimDoFrame(); }
+	const BufferStreaming &streaming() const { return dadosQuads; }
+
+private:
+	void iniciar();
+
+	GLuint programa = 0;
+	GLint locPrimeiroQuad = -1;
+	BufferStreaming dadosQuads;
+	GLuint texturaQuads = 0;
+	uint32_t geracaoLigada = 0; // do BufferStreaming, ligada ao texture buffer
+};
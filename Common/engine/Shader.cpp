@@ -0,0 +1,81 @@
+#include "Shader.h"
+
+#include <iostream>
+
+#include "ConstantesFrame.h"
+
+static bool compilarEtapa(GLuint shader, const GLchar *fonte, const char *nome)
+{
+	glShaderSource(shader, 1, &fonte, NULL);
+	glCompileShader(shader);
+	// Checando erros de compilação (exibição via log no terminal)
+	GLint success;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		GLchar infoLog[512];
+		glGetShaderInfoLog(shader, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::" << nome << "::COMPILATION_FAILED\n"
+				  << infoLog << std::endl;
+	}
+	return success;
+}
+
+GLuint setupShader(const GLchar *vsSource, const GLchar *fsSource, bool binarioRecuperavel)
+{
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	bool ok = compilarEtapa(vertexShader, vsSource, "VERTEX");
+	ok = compilarEtapa(fragmentShader, fsSource, "FRAGMENT") && ok;
+
+	// Linkando os shaders e criando o identificador do programa de shader
+	GLuint shaderProgram = glCreateProgram();
+	// glProgramParameteri é do OpenGL 4.1 (ou ARB_get_program_binary); sem ele não há
+	// binário para recuperar e o pedido é ignorado
+	if (binarioRecuperavel && (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary))
+		glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// Checando por erros de linkagem
+	GLint success;
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!ok || !success)
+	{
+		GLchar infoLog[512];
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+				  << infoLog << std::endl;
+		glDeleteProgram(shaderProgram);
+		return 0;
+	}
+	ligarConstantesFrame(shaderProgram);
+	return shaderProgram;
+}
+
+GLuint setupComputeShader(const GLchar *fonte)
+{
+	GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+	bool ok = compilarEtapa(computeShader, fonte, "COMPUTE");
+
+	GLuint programa = glCreateProgram();
+	glAttachShader(programa, computeShader);
+	glLinkProgram(programa);
+	glDeleteShader(computeShader);
+
+	GLint success;
+	glGetProgramiv(programa, GL_LINK_STATUS, &success);
+	if (!ok || !success)
+	{
+		GLchar infoLog[512];
+		glGetProgramInfoLog(programa, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+				  << infoLog << std::endl;
+		glDeleteProgram(programa);
+		return 0;
+	}
+	return programa;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Compila e linka um programa de vertex + fragment shader. Os erros de compilação
+// e de link vão para o terminal; em caso de erro retorna 0. O bloco ConstantesFrame,
+// se o programa tiver, já sai ligado ao seu ponto (ConstantesFrame.h).
+// binarioRecuperavel pede ao driver que guarde o binário (para glGetProgramBinary).
+GLuint setupShader(const GLchar *vsSource, const GLchar *fsSource, bool binarioRecuperavel = false);
+
+// Compute shader sozinho num programa (OpenGL 4.3). Mesmo tratamento de erros.
+GLuint setupComputeShader(const GLchar *fonte);
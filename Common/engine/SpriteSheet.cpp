@@ -0,0 +1,257 @@
+#include "SpriteSheet.h"
+#include "Textura.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <stb_image.h>
+
+bool SpriteSheet::importar(const std::string &arquivoImagem, int linhas, int colunas, GLint filtro, int margem)
+{
+	liberar();
+	if (!recortar(arquivoImagem, linhas, colunas, margem))
+		return false;
+
+	texID = criarTexturaRGBA(atlas.data(), atlasL, atlasA, filtro);
+	std::vector<unsigned char>().swap(atlas);
+	return texID != 0;
+}
+
+bool SpriteSheet::recortar(const std::string &arquivoImagem, int linhas, int colunas, int margem)
+{
+	for (int k = 0; k < 2; k++)
+		vertices[k].clear();
+	arquivo = arquivoImagem;
+	nLinhas = linhas;
+	nColunas = colunas;
+
+	int canais;
+	unsigned char *pixels = stbi_load(arquivo.c_str(), &imagemL, &imagemA, &canais, STBI_rgb_alpha);
+	if (!pixels)
+	{
+		std::cout << "Falha ao carregar spritesheet: " << arquivo << std::endl;
+		return false;
+	}
+	celulaL = imagemL / nColunas;
+	celulaA = imagemA / nLinhas;
+
+	// Caixa mínima dos pixels com alfa > 0 em cada célula
+	frames.assign((size_t)nLinhas * nColunas, FrameSprite());
+	for (int l = 0; l < nLinhas; l++)
+	{
+		for (int c = 0; c < nColunas; c++)
+		{
+			int x0 = celulaL, y0 = celulaA, x1 = -1, y1 = -1;
+			for (int y = 0; y < celulaA; y++)
+			{
+				const unsigned char *linha = pixels + ((size_t)(l * celulaA + y) * imagemL + c * celulaL) * 4;
+				for (int x = 0; x < celulaL; x++)
+				{
+					if (linha[x * 4 + 3] == 0)
+						continue;
+					x0 = std::min(x0, x);
+					x1 = std::max(x1, x);
+					y0 = std::min(y0, y);
+					y1 = std::max(y1, y);
+				}
+			}
+
+			FrameSprite &f = frames[l * nColunas + c];
+			if (x1 < 0)
+			{
+				f.vazio = true;
+				continue;
+			}
+			f.offsetX = x0;
+			f.offsetY = y0;
+			f.largura = x1 - x0 + 1;
+			f.altura = y1 - y0 + 1;
+		}
+	}
+
+	// Empacotamento em prateleiras, dos recortes mais altos para os mais baixos.
+	// Testa as larguras possíveis e fica com a de menor área.
+	std::vector<int> ordem;
+	int maiorLargura = 0, somaLarguras = margem;
+	for (int i = 0; i < (int)frames.size(); i++)
+	{
+		if (frames[i].vazio)
+			continue;
+		ordem.push_back(i);
+		maiorLargura = std::max(maiorLargura, frames[i].largura);
+		somaLarguras += frames[i].largura + margem;
+	}
+	std::stable_sort(ordem.begin(), ordem.end(), [this](int a, int b) { return frames[a].altura > frames[b].altura; });
+
+	auto empacotar = [&](int larguraAtlas, bool gravar) {
+		int x = margem, y = margem, alturaPrateleira = 0;
+		for (int i : ordem)
+		{
+			FrameSprite &f = frames[i];
+			if (x + f.largura + margem > larguraAtlas)
+			{
+				y += alturaPrateleira + margem;
+				x = margem;
+				alturaPrateleira = 0;
+			}
+			if (gravar)
+			{
+				f.atlasX = x;
+				f.atlasY = y;
+			}
+			x += f.largura + margem;
+			alturaPrateleira = std::max(alturaPrateleira, f.altura);
+		}
+		return y + alturaPrateleira + margem;
+	};
+
+	atlasL = atlasA = 1;
+	if (!ordem.empty())
+	{
+		long melhorArea = -1;
+		for (int l = maiorLargura + 2 * margem; l <= somaLarguras; l++)
+		{
+			int a = empacotar(l, false);
+			if (melhorArea < 0 || (long)l * a < melhorArea)
+			{
+				melhorArea = (long)l * a;
+				atlasL = l;
+				atlasA = a;
+			}
+		}
+		empacotar(atlasL, true);
+	}
+
+	atlas.assign((size_t)atlasL * atlasA * 4, 0);
+	for (int l = 0; l < nLinhas; l++)
+	{
+		for (int c = 0; c < nColunas; c++)
+		{
+			FrameSprite &f = frames[l * nColunas + c];
+			if (f.vazio)
+				continue;
+			for (int y = 0; y < f.altura; y++)
+			{
+				const unsigned char *origem = pixels + ((size_t)(l * celulaA + f.offsetY + y) * imagemL + c * celulaL + f.offsetX) * 4;
+				memcpy(&atlas[((size_t)(f.atlasY + y) * atlasL + f.atlasX) * 4], origem, (size_t)f.largura * 4);
+			}
+			f.s0 = (float)f.atlasX / atlasL;
+			f.s1 = (float)(f.atlasX + f.largura) / atlasL;
+			f.t0 = (float)f.atlasY / atlasA;
+			f.t1 = (float)(f.atlasY + f.altura) / atlasA;
+		}
+	}
+	stbi_image_free(pixels);
+	return true;
+}
+
+void SpriteSheet::liberar()
+{
+	for (int k = 0; k < 2; k++)
+	{
+		if (vaos[k])
+		{
+			glDeleteVertexArrays(1, &vaos[k]);
+			glDeleteBuffers(1, &vbos[k]);
+		}
+		vaos[k] = vbos[k] = 0;
+	}
+	if (texID)
+		glDeleteTextures(1, &texID);
+	texID = 0;
+}
+
+const GLfloat *SpriteSheet::verticesFrame(OrigemQuad origem, int linha, int coluna)
+{
+	return dadosVertices(origem).data() + primeiroVertice(linha, coluna) * 5;
+}
+
+const std::vector<GLfloat> &SpriteSheet::dadosVertices(OrigemQuad origem)
+{
+	std::vector<GLfloat> &dados = vertices[origem == OrigemQuad::Centro ? 0 : 1];
+	if (!dados.empty())
+		return dados;
+
+	// Vértices na ordem de setupSprite: superior esquerdo, inferior esquerdo,
+	// superior direito, inferior direito
+	dados.reserve(frames.size() * 4 * 5);
+	for (const FrameSprite &f : frames)
+	{
+		// Recorte em coordenadas da célula: u da esquerda para a direita, v de cima para baixo
+		float u0 = (float)f.offsetX / celulaL, u1 = (float)(f.offsetX + f.largura) / celulaL;
+		float v0 = (float)f.offsetY / celulaA, v1 = (float)(f.offsetY + f.altura) / celulaA;
+		float us[4] = {u0, u0, u1, u1}, vs[4] = {v0, v1, v0, v1};
+		float ss[4] = {f.s0, f.s0, f.s1, f.s1}, ts[4] = {f.t0, f.t1, f.t0, f.t1};
+		for (int i = 0; i < 4; i++)
+		{
+			if (origem == OrigemQuad::Centro)
+			{
+				GLfloat v[5] = {us[i] - 0.5f, 0.5f - vs[i], 0.0f, ss[i], 1.0f - ts[i]};
+				dados.insert(dados.end(), v, v + 5);
+			}
+			else
+			{
+				GLfloat v[5] = {us[i], vs[i], 0.0f, ss[i], ts[i]};
+				dados.insert(dados.end(), v, v + 5);
+			}
+		}
+	}
+	return dados;
+}
+
+GLuint SpriteSheet::vao(OrigemQuad origem)
+{
+	int k = origem == OrigemQuad::Centro ? 0 : 1;
+	if (vaos[k])
+		return vaos[k];
+
+	const std::vector<GLfloat> &dados = dadosVertices(origem);
+	glGenBuffers(1, &vbos[k]);
+	glBindBuffer(GL_ARRAY_BUFFER, vbos[k]);
+	glBufferData(GL_ARRAY_BUFFER, dados.size() * sizeof(GLfloat), dados.data(), GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &vaos[k]);
+	glBindVertexArray(vaos[k]);
+
+	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+
+	// Ponteiro pro atributo 1 - Coordenada de textura s, t
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return vaos[k];
+}
+
+size_t SpriteSheet::bytesOriginal() const
+{
+	return bytesTexturaRGBA(imagemL, imagemA);
+}
+
+size_t SpriteSheet::bytesAtlas() const
+{
+	return bytesTexturaRGBA(atlasL, atlasA);
+}
+
+double SpriteSheet::fracaoArea() const
+{
+	if (frames.empty())
+		return 0.0;
+	double area = 0.0;
+	for (const FrameSprite &f : frames)
+		area += (double)f.largura * f.altura;
+	return area / ((double)celulaL * celulaA * frames.size());
+}
+
+void SpriteSheet::relatorio(std::ostream &saida) const
+{
+	saida << "Spritesheet " << arquivo << ": " << nLinhas << "x" << nColunas << " frames de "
+		  << celulaL << "x" << celulaA << ", imagem " << imagemL << "x" << imagemA << " (" << bytesOriginal() / 1024.0
+		  << " KiB) -> atlas " << atlasL << "x" << atlasA << " (" << bytesAtlas() / 1024.0 << " KiB), quads com "
+		  << fracaoArea() * 100.0 << "% da área das células" << std::endl;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Spritesheet em grade (nLinhas x nColunas células do mesmo tamanho) importada com
+// as bordas transparentes de cada frame recortadas. Os recortes são empacotados em
+// prateleiras num atlas menor que a imagem original, e cada frame vira um quad do
+// tamanho do recorte, posicionado dentro da célula: a textura ocupa menos memória e
+// os pixels totalmente transparentes deixam de ser rasterizados.
+//
+//   SpriteSheet folha;
+//   folha.importar("../assets/sprites/Vampires1_Walk_full.png", 4, 6);
+//   GLuint VAO = folha.vao(OrigemQuad::Centro);   // no lugar de setupSprite
+//   ...
+//   glBindTexture(GL_TEXTURE_2D, folha.textura());
+//   glBindVertexArray(VAO);
+//   glDrawArrays(GL_TRIANGLE_STRIP, folha.primeiroVertice(linha, coluna), 4);
+//
+// Como nos outros objetos da engine, o destrutor não chama OpenGL (o contexto pode
+// já ter sido destruído): liberar() apaga a textura e os VAOs.
+
+// Um frame recortado. Linhas e colunas seguem a imagem (linha 0 = topo).
+struct FrameSprite {
+	bool vazio = false;               // frame todo transparente: quad degenerado
+	int atlasX = 0, atlasY = 0;       // canto superior esquerdo do recorte no atlas
+	int largura = 0, altura = 0;      // tamanho do recorte, em pixels
+	int offsetX = 0, offsetY = 0;     // posição do recorte dentro da célula original
+	float s0 = 0, t0 = 0, s1 = 0, t1 = 0; // recorte no atlas (t = 0 na primeira linha)
+};
+
+// Convenção do quad da célula, para usar os VAOs com os shaders que já existem
+enum class OrigemQuad {
+	// Como setupSprite: célula de -0.5 a 0.5 com y para cima, t gravado como 1 - t
+	// (os shaders fazem tex_coord = (s, 1 - t)). Desenhar com offsetTex = (0, 0).
+	Centro,
+	// Como o quad do SpriteRenderer: célula de 0 a 1 com y para baixo, t direto.
+	// Desenhar com uvOffset = (0, 0) e uvScale = (1, 1).
+	CantoSuperiorEsquerdo
+};
+
+class SpriteSheet {
+public:
+	SpriteSheet() = default;
+	SpriteSheet(const SpriteSheet &) = delete;
+	SpriteSheet &operator=(const SpriteSheet &) = delete;
+
+	// Decodifica a imagem, recorta cada célula pelo alfa e cria o atlas. margem =
+	// pixels transparentes entre os recortes no atlas (evita vazamento na filtragem).
+	bool importar(const std::string &arquivo, int nLinhas, int nColunas, GLint filtro = GL_NEAREST, int margem = 1);
+	void liberar();
+
+	// Só a parte de CPU de importar(): o atlas fica em atlasRGBA() e nenhuma textura
+	// é criada (não precisa de contexto OpenGL; usado com o RasterizadorCPU)
+	bool recortar(const std::string &arquivo, int nLinhas, int nColunas, int margem = 1);
+	const std::vector<unsigned char> &atlasRGBA() const { return atlas; }
+	int larguraAtlas() const { return atlasL; }
+	int alturaAtlas() const { return atlasA; }
+
+	GLuint textura() const { return texID; }
+
+	// Um VAO com 4 vértices (x, y, z, s, t) por frame, em GL_TRIANGLE_STRIP, na ordem
+	// linha a linha; criado na primeira chamada para cada origem
+	GLuint vao(OrigemQuad origem);
+	GLint primeiroVertice(int linha, int coluna) const { return 4 * (linha * nColunas + coluna); }
+
+	// Os 4 vértices do frame que estão no VAO, em memória
+	const GLfloat *verticesFrame(OrigemQuad origem, int linha, int coluna);
+
+	const FrameSprite &frame(int linha, int coluna) const { return frames[linha * nColunas + coluna]; }
+	int linhas() const { return nLinhas; }
+	int colunas() const { return nColunas; }
+	int larguraCelula() const { return celulaL; }
+	int alturaCelula() const { return celulaA; }
+
+	// Memória de GPU da imagem original e do atlas (RGBA8 com mipmaps) e a fração da
+	// área das células coberta pelos quads recortados
+	size_t bytesOriginal() const;
+	size_t bytesAtlas() const;
+	double fracaoArea() const;
+	void relatorio(std::ostream &saida) const;
+
+private:
+	std::string arquivo;
+	int nLinhas = 0, nColunas = 0;
+	int celulaL = 0, celulaA = 0;
+	int imagemL = 0, imagemA = 0;
+	int atlasL = 0, atlasA = 0;
+	std::vector<FrameSprite> frames;
+	std::vector<unsigned char> atlas;      // só entre recortar() e o envio para a GPU
+	std::vector<GLfloat> vertices[2];      // por OrigemQuad
+	GLuint texID = 0;
+	GLuint vaos[2] = {0, 0}, vbos[2] = {0, 0};
+
+	const std::vector<GLfloat> &dadosVertices(OrigemQuad origem);
+};
@@ -0,0 +1,105 @@
+#include "Tempo.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <GLFW/glfw3.h>
+
+void ContadorFPS::atualizar(GLFWwindow *window, const char *titulo)
+{
+	double agora = glfwGetTime();
+	if (anterior < 0.0)
+		anterior = agora;
+	double decorrido = agora - anterior;
+	anterior = agora;
+
+	contagemRegressiva -= decorrido;
+	if (contagemRegressiva <= 0.0 && decorrido > 0.0)
+	{
+		ultimoFps = 1.0 / decorrido;
+		char tmp[256];
+		snprintf(tmp, sizeof(tmp), "%s\tFPS %.2lf", titulo, ultimoFps);
+		glfwSetWindowTitle(window, tmp);
+		contagemRegressiva = 0.1;
+	}
+}
+
+namespace {
+
+void pedirRedesenho(GLFWwindow *window)
+{
+	static_cast<AgendadorRedesenho *>(glfwGetWindowUserPointer(window))->pedir();
+}
+
+} // namespace
+
+void AgendadorRedesenho::instalar(GLFWwindow *window)
+{
+	glfwSetWindowUserPointer(window, this);
+	glfwSetWindowRefreshCallback(window, [](GLFWwindow *w) { pedirRedesenho(w); });
+	glfwSetFramebufferSizeCallback(window, [](GLFWwindow *w, int, int) { pedirRedesenho(w); });
+	glfwSetWindowFocusCallback(window, [](GLFWwindow *w, int) { pedirRedesenho(w); });
+	glfwSetWindowIconifyCallback(window, [](GLFWwindow *w, int) { pedirRedesenho(w); });
+}
+
+bool AgendadorRedesenho::esperar()
+{
+	double agora = glfwGetTime();
+	if (inicio < 0.0)
+		inicio = inicioSegundo = agora;
+
+	// Os callbacks rodam aqui dentro e podem pedir redesenho
+	if (!pendente && proximoTick > agora)
+	{
+		glfwWaitEventsTimeout(std::min(proximoTick - agora, ESPERA_MAXIMA));
+		double depois = glfwGetTime();
+		segundosDormindo += depois - agora;
+		agora = depois;
+	}
+	else
+		glfwPollEvents();
+	despertares++;
+
+	if (agora >= proximoTick)
+		pendente = true;
+
+	// O segundo fecha mesmo sem redesenho, para a taxa chegar a zero
+	if (agora - inicioSegundo >= 1.0)
+	{
+		ultimaTaxa = redesenhosNoSegundo / (agora - inicioSegundo);
+		redesenhosNoSegundo = 0;
+		inicioSegundo = agora;
+		taxaNova = true;
+	}
+
+	bool desenhar = pendente;
+	pendente = false;
+	if (!desenhar)
+		despertaresVazios++;
+	return desenhar;
+}
+
+void AgendadorRedesenho::desenhou()
+{
+	redesenhos++;
+	redesenhosNoSegundo++;
+}
+
+void AgendadorRedesenho::atualizarTitulo(GLFWwindow *window, const char *titulo)
+{
+	if (!taxaNova)
+		return;
+	char tmp[256];
+	snprintf(tmp, sizeof(tmp), "%s\tRedesenhos/s %.1lf", titulo, ultimaTaxa);
+	glfwSetWindowTitle(window, tmp);
+	taxaNova = false;
+}
+
+void AgendadorRedesenho::relatorio(std::ostream &saida) const
+{
+	double total = inicio < 0.0 ? 0.0 : glfwGetTime() - inicio;
+	saida << "Redesenho por eventos: " << redesenhos << " redesenhos em " << total << " s ("
+		  << (total > 0.0 ? redesenhos / total : 0.0) << " por segundo), " << despertaresVazios << " de "
+		  << despertares << " despertares sem redesenho, " << (total > 0.0 ? 100.0 * segundosDormindo / total : 0.0)
+		  << "% do tempo dormindo\n";
+}
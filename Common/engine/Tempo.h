@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+struct GLFWwindow;
+
+// Mostra o FPS na barra de título, atualizando a cada 0,1 s para o número não
+// oscilar a cada frame. Chamar uma vez por frame.
+class ContadorFPS {
+public:
+	// const char *: um literal passado aqui não vira std::string (alocação) a cada frame
+	void atualizar(GLFWwindow *window, const char *titulo);
+	void atualizar(GLFWwindow *window, const std::string &titulo) { atualizar(window, titulo.c_str()); }
+
+	double fps() const { return ultimoFps; }
+
+private:
+	double anterior = -1.0;
+	double contagemRegressiva = 0.1;
+	double ultimoFps = 0.0;
+};
+
+// Redesenho por eventos, para jogos em que nada muda sem o jogador: em vez de
+// desenhar sem parar, o loop dorme em glfwWaitEventsTimeout até chegar um evento que
+// peça redesenho (pedir(), chamado pelos callbacks de entrada; os de janela —
+// exposição, tamanho, foco e minimização — são instalados aqui) ou o instante do
+// próximo tick de animação (agendar()). Usa o user pointer da janela.
+//
+//   agendador.instalar(window);
+//   while (!glfwWindowShouldClose(window)) {
+//       if (!agendador.esperar())
+//           continue;                       // acordou sem nada para desenhar
+//       ... desenha ...
+//       agendador.agendar(proximoFrameDaAnimacao);
+//       agendador.desenhou();
+//   }
+class AgendadorRedesenho {
+public:
+	// Nenhuma espera passa disso, para quem precisa verificar algo de tempos em tempos
+	// (shaders editados em disco, por exemplo)
+	static constexpr double ESPERA_MAXIMA = 0.5;
+
+	void instalar(GLFWwindow *window);
+
+	void pedir() { pendente = true; }
+	// Instante (glfwGetTime) em que o próximo frame deve ser desenhado sem evento
+	void agendar(double instante) { proximoTick = instante; }
+
+	// Processa os eventos (dormindo se não houver nada pendente); true se há o que desenhar
+	bool esperar();
+	void desenhou();
+
+	// Redesenhos no último segundo completo
+	double redesenhosPorSegundo() const { return ultimaTaxa; }
+	// Mostra os redesenhos por segundo na barra de título quando o valor muda de segundo
+	void atualizarTitulo(GLFWwindow *window, const char *titulo);
+	void relatorio(std::ostream &saida) const;
+
+private:
+	bool pendente = true;
+	double proximoTick = 0.0;
+
+	double inicio = -1.0, inicioSegundo = -1.0, segundosDormindo = 0.0;
+	int redesenhosNoSegundo = 0;
+	double ultimaTaxa = 0.0;
+	bool taxaNova = false;
+	uint64_t redesenhos = 0, despertares = 0, despertaresVazios = 0;
+};
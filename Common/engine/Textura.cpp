@@ -0,0 +1,148 @@
+#include "Textura.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// A implementação da stb_image fica só aqui, compilada uma vez para todos os programas
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// glTexStorage* é do OpenGL 4.2 (ou ARB_texture_storage); sem ele, o nível 0 vai
+// com glTexImage* e o glGenerateMipmap cria os outros
+static bool armazenamentoImutavel()
+{
+	return GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage;
+}
+
+GLuint criarTexturaRGBA(const unsigned char *data, int width, int height, GLint filtro)
+{
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filtro);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtro);
+
+	if (armazenamentoImutavel())
+	{
+		int niveis = 1 + (int)std::floor(std::log2((double)std::max(width, height)));
+		glTexStorage2D(GL_TEXTURE_2D, niveis, GL_RGBA8, width, height);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texID;
+}
+
+GLuint loadTexture(const std::string &filePath, int &width, int &height, GLint filtro)
+{
+	int nrChannels;
+	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+	if (!data)
+	{
+		std::cout << "Falha ao carregar textura: " << filePath << std::endl;
+		width = height = 0;
+		return 0;
+	}
+
+	GLuint texID = criarTexturaRGBA(data, width, height, filtro);
+	stbi_image_free(data);
+	return texID;
+}
+
+GLuint loadTextureMemoria(const unsigned char *dados, size_t tamanho, int &width, int &height, GLint filtro)
+{
+	int nrChannels;
+	unsigned char *data = stbi_load_from_memory(dados, (int)tamanho, &width, &height, &nrChannels, STBI_rgb_alpha);
+	if (!data)
+	{
+		std::cout << "Falha ao decodificar textura da memória" << std::endl;
+		width = height = 0;
+		return 0;
+	}
+
+	GLuint texID = criarTexturaRGBA(data, width, height, filtro);
+	stbi_image_free(data);
+	return texID;
+}
+
+GLuint loadTextureArray(const std::string &filePath, int nCamadas, int &larguraCamada, int &alturaCamada, GLint filtro)
+{
+	int width, height, nrChannels;
+	larguraCamada = alturaCamada = 0;
+	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+	if (!data)
+	{
+		std::cout << "Falha ao carregar textura: " << filePath << std::endl;
+		return 0;
+	}
+	if (nCamadas <= 0 || width % nCamadas != 0)
+	{
+		std::cout << "Textura " << filePath << ": largura " << width << " não se divide em " << nCamadas << " camadas" << std::endl;
+		stbi_image_free(data);
+		return 0;
+	}
+
+	int w = width / nCamadas, h = height;
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// Ampliado, o filtro pedido; reduzido, também entre níveis de mipmap
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filtro == GL_LINEAR ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filtro);
+
+	if (armazenamentoImutavel())
+	{
+		int niveis = 1 + (int)std::floor(std::log2((double)std::max(w, h)));
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, niveis, GL_RGBA8, w, h, nCamadas);
+	}
+	else
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, w, h, nCamadas, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+	// Cada camada é uma janela da imagem: linhas de width pixels, começando na coluna k * w
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+	for (int k = 0; k < nCamadas; k++)
+	{
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, k * w);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, k, w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	stbi_image_free(data);
+
+	larguraCamada = w;
+	alturaCamada = h;
+	return texID;
+}
+
+GLuint loadTexture(const std::string &filePath, GLint filtro)
+{
+	int width, height;
+	return loadTexture(filePath, width, height, filtro);
+}
+
+size_t bytesTexturaRGBA(int width, int height)
+{
+	size_t total = 0;
+	while (true)
+	{
+		total += (size_t)width * height * 4;
+		if (width == 1 && height == 1)
+			break;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return total;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <glad/glad.h>
+
+// Carrega uma imagem (png, jpg, bmp...) em uma textura 2D com mipmaps. A imagem é
+// sempre expandida para RGBA8: as linhas ficam alinhadas em 4 bytes em qualquer
+// largura e, com OpenGL 4.2 ou ARB_texture_storage, o armazenamento é imutável
+// (glTexStorage2D), alocado uma vez só; sem eles, glTexImage2D.
+// Em caso de erro a mensagem vai para o terminal e o retorno é 0.
+GLuint loadTexture(const std::string &filePath, int &width, int &height, GLint filtro = GL_NEAREST);
+GLuint loadTexture(const std::string &filePath, GLint filtro = GL_NEAREST);
+
+// O mesmo, a partir do arquivo já lido para a memória (dados = conteúdo do png/jpg)
+GLuint loadTextureMemoria(const unsigned char *dados, size_t tamanho, int &width, int &height, GLint filtro = GL_NEAREST);
+
+// Textura a partir de pixels RGBA8 já na memória (ex.: um atlas montado na CPU)
+GLuint criarTexturaRGBA(const unsigned char *data, int width, int height, GLint filtro = GL_NEAREST);
+
+// Tileset em faixa horizontal (nCamadas imagens lado a lado) numa GL_TEXTURE_2D_ARRAY
+// com uma camada por imagem. Cada camada tem a sua cadeia de mipmaps, gerada só com os
+// próprios pixels, e as bordas são GL_CLAMP_TO_EDGE: filtragem e mipmaps não misturam
+// tiles vizinhos, o que acontece com a faixa e offsetTex. O shader escolhe o tile pelo
+// índice da camada (sampler2DArray, vec3(s, t, camada)). larguraCamada e alturaCamada
+// recebem o tamanho de um tile; a largura da imagem precisa ser múltipla de nCamadas.
+GLuint loadTextureArray(const std::string &filePath, int nCamadas, int &larguraCamada, int &alturaCamada, GLint filtro = GL_NEAREST);
+
+// Memória de GPU de uma textura RGBA8 com todos os níveis de mipmap
+size_t bytesTexturaRGBA(int width, int height);
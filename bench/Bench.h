@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <FrameReport.h>
+
+// Execução das cargas do pg_bench: cada carga roda algumas vezes sem medir
+// (aquecimento: caches, páginas, threads criadas) e depois N vezes medindo. O
+// resumo usa estatísticas robustas, que um tempo perdido para o escalonador não
+// desloca: mediana, MAD (mediana dos desvios absolutos até a mediana) e p99.
+//
+//   Bench bench(aquecimento, repeticoes, filtro);
+//   bench.medir("mapa/iterar", [&] { return somarTiles(mapa); });
+//   bench.medir("cores/eliminar", [&] { grade.reviverTodas(); },        // preparar (fora do tempo)
+//                                 [&] { return grade.eliminarSimilares(alvo, limiar); });
+//   bench.salvarJson("bench.json", rotulo);
+//
+// A carga retorna um número (itens processados, soma, ...) que é acumulado e
+// impresso no fim, para o compilador não eliminar o trabalho.
+struct ResultadoBench {
+	std::string nome;
+	int repeticoes;
+	double mediana, mad, p99, minimo, maximo; // ms
+};
+
+class Bench {
+public:
+	Bench(int aquecimento, int repeticoes, const std::string &filtro)
+		: aquecimento(aquecimento), repeticoes(repeticoes), filtro(filtro)
+	{
+	}
+
+	// Só as cargas cujo nome contém o filtro são executadas
+	bool ativa(const std::string &nome) const { return filtro.empty() || nome.find(filtro) != std::string::npos; }
+
+	template <typename F>
+	void medir(const std::string &nome, F &&carga)
+	{
+		medir(nome, [] {}, carga);
+	}
+
+	template <typename P, typename F>
+	void medir(const std::string &nome, P &&preparar, F &&carga)
+	{
+		if (!ativa(nome))
+			return;
+
+		for (int k = 0; k < aquecimento; k++) {
+			preparar();
+			sumidouro += (uint64_t)carga();
+		}
+
+		std::vector<double> tempos(repeticoes);
+		for (int k = 0; k < repeticoes; k++) {
+			preparar();
+			auto t0 = std::chrono::steady_clock::now();
+			sumidouro += (uint64_t)carga();
+			auto t1 = std::chrono::steady_clock::now();
+			tempos[k] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+		}
+
+		ResultadoBench r = resumir(nome, tempos);
+		printf("  %-40s %10.4f ms  ±%8.4f  p99 %10.4f  (min %.4f, max %.4f)\n",
+			   r.nome.c_str(), r.mediana, r.mad, r.p99, r.minimo, r.maximo);
+		fflush(stdout);
+		resultados.push_back(r);
+	}
+
+	const std::vector<ResultadoBench> &todos() const { return resultados; }
+	uint64_t verificacao() const { return sumidouro; }
+
+	// {"rotulo": "...", "aquecimento": W, "repeticoes": N, "resultados": [
+	//   {"nome": "...", "repeticoes": N, "mediana_ms": ..., "mad_ms": ..., "p99_ms": ...,
+	//    "min_ms": ..., "max_ms": ...}, ...]}
+	bool salvarJson(const std::string &arquivo, const std::string &rotulo) const
+	{
+		FILE *f = fopen(arquivo.c_str(), "w");
+		if (!f)
+			return false;
+
+		fprintf(f, "{\"rotulo\": \"%s\", \"aquecimento\": %d, \"repeticoes\": %d, \"resultados\": [",
+				textoJson(rotulo).c_str(), aquecimento, repeticoes);
+		for (size_t k = 0; k < resultados.size(); k++) {
+			const ResultadoBench &r = resultados[k];
+			fprintf(f, "%s\n  {\"nome\": \"%s\", \"repeticoes\": %d, \"mediana_ms\": %.6f, \"mad_ms\": %.6f, "
+					   "\"p99_ms\": %.6f, \"min_ms\": %.6f, \"max_ms\": %.6f}",
+					k ? "," : "", textoJson(r.nome).c_str(), r.repeticoes, r.mediana, r.mad, r.p99, r.minimo, r.maximo);
+		}
+		fprintf(f, "\n]}\n");
+		fclose(f);
+		return true;
+	}
+
+private:
+	static ResultadoBench resumir(const std::string &nome, std::vector<double> tempos)
+	{
+		ResultadoBench r;
+		r.nome = nome;
+		r.repeticoes = (int)tempos.size();
+		std::sort(tempos.begin(), tempos.end());
+		r.mediana = mediana(tempos);
+		r.p99 = FrameReport::percentil(tempos, 0.99);
+		r.minimo = tempos.empty() ? 0.0 : tempos.front();
+		r.maximo = tempos.empty() ? 0.0 : tempos.back();
+
+		std::vector<double> desvios(tempos.size());
+		for (size_t k = 0; k < tempos.size(); k++)
+			desvios[k] = std::fabs(tempos[k] - r.mediana);
+		std::sort(desvios.begin(), desvios.end());
+		r.mad = mediana(desvios);
+		return r;
+	}
+
+	// Mediana de um vetor já ordenado (média dos dois do meio quando o tamanho é par)
+	static double mediana(const std::vector<double> &ordenados)
+	{
+		size_t n = ordenados.size();
+		if (n == 0)
+			return 0.0;
+		return n % 2 ? ordenados[n / 2] : 0.5 * (ordenados[n / 2 - 1] + ordenados[n / 2]);
+	}
+
+	int aquecimento, repeticoes;
+	std::string filtro;
+	std::vector<ResultadoBench> resultados;
+	uint64_t sumidouro = 0;
+};
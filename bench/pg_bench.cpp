@@ -0,0 +1,362 @@
+/* pg_bench - medição das partes de CPU dos exercícios, para comparar commits
+ *
+ * Cargas (o nome de cada uma é o que aparece na saída e no JSON):
+ *   mapa/     carregarMapa (o loadMapConfig do Desafio) em texto e binário, iteração
+ *             sobre todos os tiles e culling da janela da câmera (Common/CullingIso.h)
+ *   picking/  pickIsometrico em pontos aleatórios (Common/Picking.h)
+ *   cores/    GradeCores::eliminarSimilares do M3, por métrica e kernel
+ *   sprites/  atualização de animação de muitos sprites
+ *   textura/  decodificação dos PNGs dos assets (stb_image)
+ *   render/   frames do mapa rasterizados sem GPU (RasterizadorCPU)
+ *
+ * Uso: pg_bench [--json saida.json] [--rotulo texto] [--repeticoes n] [--aquecimento n]
+ *               [--filtro texto] [--mapa n] [--assets dir]
+ *
+ * Roda do diretório de build, como os exercícios (assets em ../assets/). Os mapas
+ * são gerados com semente fixa e gravados numa pasta temporária.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stb_image.h>
+
+#include <MapaIso.h>
+#include <CullingIso.h>
+#include <Picking.h>
+#include <GradeCores.h>
+
+#include <Engine.h>
+
+#include "Bench.h"
+
+using namespace std;
+using namespace glm;
+
+namespace fs = std::filesystem;
+
+const int LARGURA_TELA = 800, ALTURA_TELA = 600;
+
+// O Desafio desenha os tiles do tilesetIso.png com 32x16 pixels na tela
+const float TILE_W = 32.0f, TILE_H = 16.0f;
+
+static uint32_t hash32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7FEB352DU;
+	x ^= x >> 15;
+	x *= 0x846CA68BU;
+	x ^= x >> 16;
+	return x;
+}
+
+// Números pseudoaleatórios reproduzíveis em [0, 1)
+static float aleatorio(uint32_t &estado)
+{
+	estado = hash32(estado + 0x9E3779B9U);
+	return (estado >> 8) * (1.0f / 16777216.0f);
+}
+
+// Mapa com o mesmo tileset e propriedades do GeradorMapa, mas com ruído simples
+// (aqui importa o tamanho e a mistura de IDs, não o relevo)
+static MapaIso gerarMapa(int largura, int altura, uint32_t semente)
+{
+	MapaIso mapa;
+	mapa.tilesetFile = "tilesetIso.png";
+	mapa.nTiles = 7;
+	mapa.tileWidth = 16;
+	mapa.tileHeight = 32;
+	mapa.largura = largura;
+	mapa.altura = altura;
+	mapa.tiles.resize((size_t)largura * altura);
+	mapa.props = {
+		{false, false, false}, {false, false, false}, {false, false, false}, {false, true, false},
+		{true, false, false},  {false, true, false},  {false, false, true},
+	};
+	for (size_t k = 0; k < mapa.tiles.size(); k++) {
+		uint32_t h = hash32(semente ^ hash32((uint32_t)k));
+		mapa.tiles[k] = (uint16_t)(h % 1000 < 2 ? 6 : h % 1000 < 30 ? 3 : h % 3);
+	}
+	return mapa;
+}
+
+// Centro do tile [i][j] no mundo, com o tile [0][0] começando na origem
+static vec2 centroTile(int i, int j)
+{
+	return vec2((j - i) * TILE_W / 2.0f + TILE_W / 2.0f, (j + i) * TILE_H / 2.0f + TILE_H / 2.0f);
+}
+
+// Tiles visitados pelo desenho do mapa com a câmera centrada em centro
+static size_t contarVisiveis(const MapaIso &mapa, vec2 centro, float zoom)
+{
+	float meiaL = LARGURA_TELA / 2.0f / zoom, meiaA = ALTURA_TELA / 2.0f / zoom;
+	FaixaIso faixa = faixaVisivelIso(0.0f, 0.0f, TILE_W, TILE_H, mapa.altura, mapa.largura,
+									 centro.x - meiaL, centro.x + meiaL, centro.y - meiaA, centro.y + meiaA);
+	size_t soma = 0;
+	for (int i = faixa.iMin; i <= faixa.iMax; i++)
+		for (int j = faixa.jMin(i); j <= faixa.jMax(i); j++)
+			soma += mapa.at(i, j) + 1;
+	return soma;
+}
+
+// Estado de animação de um sprite como o vampirão: frame trocado a 12 FPS
+struct SpriteAnimado {
+	int iAnimation, iFrame;
+	int nAnimations, nFrames;
+	float acumulado;
+	vec2 posicao, velocidade;
+};
+
+static size_t animar(vector<SpriteAnimado> &sprites, float dt)
+{
+	const float PERIODO = 1.0f / 12.0f;
+	size_t trocas = 0;
+	for (SpriteAnimado &s : sprites) {
+		s.posicao += s.velocidade * dt;
+		s.acumulado += dt;
+		if (s.acumulado >= PERIODO) {
+			s.acumulado -= PERIODO;
+			s.iFrame = (s.iFrame + 1) % s.nFrames;
+			trocas++;
+		}
+		// Linha da animação pelo sentido do movimento
+		s.iAnimation = std::abs(s.velocidade.x) > std::abs(s.velocidade.y)
+						   ? (s.velocidade.x > 0.0f ? 2 : 1)
+						   : (s.velocidade.y > 0.0f ? 0 : 3);
+	}
+	return trocas;
+}
+
+static bool lerBytes(const string &arquivo, vector<unsigned char> &bytes)
+{
+	ifstream f(arquivo, ios::binary);
+	if (!f)
+		return false;
+	bytes.assign(istreambuf_iterator<char>(f), istreambuf_iterator<char>());
+	return true;
+}
+
+// Um frame do mapa no rasterizador de CPU: mesmo culling e mesmos quads do desenharMapa
+static size_t desenharMapaCPU(RasterizadorCPU &cpu, const MapaIso &mapa, GLuint texID, vec2 centro, float zoom)
+{
+	mat4 projection = ortho(0.0f, (float)LARGURA_TELA, (float)ALTURA_TELA, 0.0f, -1.0f, 1.0f);
+	mat4 view = translate(mat4(1.0f), vec3(LARGURA_TELA / 2.0f, ALTURA_TELA / 2.0f, 0.0f));
+	view = scale(view, vec3(zoom, zoom, 1.0f));
+	view = translate(view, vec3(-centro.x, -centro.y, 0.0f));
+
+	cpu.limpar(0.0f, 0.0f, 0.0f, 1.0f);
+	cpu.projecao(projection * view);
+
+	float meiaL = LARGURA_TELA / 2.0f / zoom, meiaA = ALTURA_TELA / 2.0f / zoom;
+	FaixaIso faixa = faixaVisivelIso(0.0f, 0.0f, TILE_W, TILE_H, mapa.altura, mapa.largura,
+									 centro.x - meiaL, centro.x + meiaL, centro.y - meiaA, centro.y + meiaA);
+	const GLfloat *vertices = verticesTile(mapa.nTiles);
+	size_t quads = 0;
+	for (int i = faixa.iMin; i <= faixa.iMax; i++) {
+		for (int j = faixa.jMin(i); j <= faixa.jMax(i); j++) {
+			QuadTexturizado quad;
+			quad.vertices = vertices;
+			quad.textura = texID;
+			quad.model = translate(quad.model, vec3((j - i) * TILE_W / 2.0f, (j + i) * TILE_H / 2.0f, 0.0f));
+			quad.model = scale(quad.model, vec3(TILE_W, TILE_H, 1.0f));
+			quad.offsetTex = vec2(mapa.at(i, j) / (float)mapa.nTiles, 0.0f);
+			cpu.desenhar(quad);
+			quads++;
+		}
+	}
+	cpu.finalizarFrame();
+	return quads + cpu.pixels()[cpu.pixels().size() / 2];
+}
+
+int main(int argc, char **argv)
+{
+	string arquivoJson, rotulo, filtro;
+	string assets = "../assets/";
+	int repeticoes = 30, aquecimento = 3;
+	int lado = 1000;
+
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		bool temValor = i + 1 < argc;
+		if (arg == "--json" && temValor) arquivoJson = argv[++i];
+		else if (arg == "--rotulo" && temValor) rotulo = argv[++i];
+		else if (arg == "--repeticoes" && temValor) repeticoes = std::max(1, atoi(argv[++i]));
+		else if (arg == "--aquecimento" && temValor) aquecimento = std::max(0, atoi(argv[++i]));
+		else if (arg == "--filtro" && temValor) filtro = argv[++i];
+		else if (arg == "--mapa" && temValor) lado = std::max(16, atoi(argv[++i]));
+		else if (arg == "--assets" && temValor) assets = argv[++i];
+		else {
+			cerr << "Uso: " << argv[0] << " [--json saida.json] [--rotulo texto] [--repeticoes n] "
+				 << "[--aquecimento n] [--filtro texto] [--mapa n] [--assets dir]" << endl;
+			return 1;
+		}
+	}
+
+	Bench bench(aquecimento, repeticoes, filtro);
+	cout << "pg_bench: " << repeticoes << " repetições (+" << aquecimento << " de aquecimento), "
+		 << "mediana ± MAD" << endl;
+
+	// ---- Mapas ----
+	string tam = to_string(lado) + "x" + to_string(lado);
+	MapaIso mapa = gerarMapa(lado, lado, 42);
+
+	fs::path pasta = fs::temp_directory_path();
+	string arquivoTexto = (pasta / "pg_bench_mapa.txt").string();
+	string arquivoBinario = (pasta / "pg_bench_mapa.pgmap").string();
+	if (!salvarMapaTexto(arquivoTexto, mapa) || !salvarMapaBinario(arquivoBinario, mapa)) {
+		cerr << "Não foi possível gravar os mapas em " << pasta << endl;
+		return 1;
+	}
+	bench.medir("mapa/carregar-texto-" + tam, [&] {
+		MapaIso m;
+		return carregarMapa(arquivoTexto, m) ? m.tiles.size() : 0;
+	});
+	bench.medir("mapa/carregar-binario-" + tam, [&] {
+		MapaIso m;
+		return carregarMapa(arquivoBinario, m) ? m.tiles.size() : 0;
+	});
+	std::error_code erro;
+	fs::remove(arquivoTexto, erro);
+	fs::remove(arquivoBinario, erro);
+
+	// Contagem de moedas do loadMapConfig: passa por todos os tiles
+	bench.medir("mapa/iterar-" + tam, [&] {
+		size_t moedas = 0;
+		for (uint16_t id : mapa.tiles)
+			moedas += mapa.props[id].isCollectible;
+		return moedas;
+	});
+
+	// Culling com a câmera em 64 posições ao longo da diagonal do mapa
+	vector<vec2> centros(64);
+	for (size_t k = 0; k < centros.size(); k++) {
+		int t = (int)((k + 0.5) * lado / centros.size());
+		centros[k] = centroTile(t, t);
+	}
+	for (float zoom : {1.0f, 0.1f}) {
+		char nome[64];
+		snprintf(nome, sizeof(nome), "mapa/culling-zoom%g-%zux", zoom, centros.size());
+		bench.medir(nome, [&] {
+			size_t soma = 0;
+			for (vec2 c : centros)
+				soma += contarVisiveis(mapa, c, zoom);
+			return soma;
+		});
+	}
+
+	// ---- Picking ----
+	const int N_CLIQUES = 1000000;
+	vector<vec2> cliques(N_CLIQUES);
+	uint32_t estado = 7;
+	float larguraMundo = (mapa.largura + mapa.altura) * TILE_W / 2.0f;
+	float alturaMundo = (mapa.largura + mapa.altura) * TILE_H / 2.0f;
+	for (vec2 &p : cliques)
+		p = vec2((aleatorio(estado) - 0.5f) * larguraMundo, aleatorio(estado) * alturaMundo);
+	bench.medir("picking/isometrico-1M", [&] {
+		size_t acertos = 0;
+		int i, j;
+		for (vec2 p : cliques)
+			acertos += pickIsometrico(p, vec2(0.0f), vec2(TILE_W, TILE_H), mapa.altura, mapa.largura, i, j);
+		return acertos;
+	});
+
+	// ---- Cores (M3) ----
+	{
+		GradeCores grade;
+		grade.redimensionar((size_t)lado * lado);
+		estado = 11;
+		for (size_t k = 0; k < grade.size(); k++)
+			grade.definir(k, vec3(aleatorio(estado), aleatorio(estado), aleatorio(estado)));
+		vec3 alvo = grade.cor(grade.size() / 2);
+		CorLab alvoLab = grade.lab(grade.size() / 2);
+		const float limiarRGB = 0.2f * sqrt(3.0f);
+
+		for (int k = KERNEL_ESCALAR; k <= KERNEL_AVX2; k++) {
+			KernelCores kernel = (KernelCores)k;
+			if (!grade.usarKernel(kernel))
+				continue;
+			string sufixo = string(GradeCores::nomeKernel(kernel)) + "-" + tam;
+			bench.medir("cores/eliminar-rgb-" + sufixo, [&] { grade.reviverTodas(); },
+						[&] { return grade.eliminarSimilares(alvo, limiarRGB * limiarRGB); });
+			bench.medir("cores/eliminar-de76-" + sufixo, [&] { grade.reviverTodas(); },
+						[&] { return grade.eliminarSimilares(alvoLab, 35.0f, METRICA_DE76); });
+		}
+		grade.usarKernel(GradeCores::melhorKernel());
+		bench.medir("cores/eliminar-de2000-" + tam, [&] { grade.reviverTodas(); },
+					[&] { return grade.eliminarSimilares(alvoLab, 18.0f, METRICA_DE2000); });
+	}
+
+	// ---- Sprites ----
+	vector<SpriteAnimado> sprites(100000);
+	estado = 13;
+	for (SpriteAnimado &s : sprites) {
+		s.nAnimations = 4;
+		s.nFrames = 6;
+		s.iAnimation = 0;
+		s.iFrame = (int)(aleatorio(estado) * s.nFrames);
+		s.acumulado = aleatorio(estado) / 12.0f;
+		s.posicao = vec2(aleatorio(estado), aleatorio(estado)) * 800.0f;
+		s.velocidade = vec2(aleatorio(estado) - 0.5f, aleatorio(estado) - 0.5f) * 200.0f;
+	}
+	bench.medir("sprites/animar-100k", [&] { return animar(sprites, 1.0f / 60.0f); });
+
+	// ---- Texturas ----
+	for (const char *arquivo : {"tilesets/tilesetIso.png", "sprites/Vampires1_Walk_full.png",
+								"backgrounds/2_game_background.png"}) {
+		string nome = string("textura/decodificar-") + fs::path(arquivo).filename().string();
+		if (!bench.ativa(nome))
+			continue;
+		vector<unsigned char> bytes;
+		if (!lerBytes(assets + arquivo, bytes)) {
+			cerr << "  " << nome << ": " << assets + arquivo << " não encontrado, ignorado" << endl;
+			continue;
+		}
+		bench.medir(nome, [&] {
+			int w, h, canais;
+			unsigned char *data = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &w, &h, &canais, STBI_rgb_alpha);
+			stbi_image_free(data);
+			return (size_t)w * h;
+		});
+	}
+
+	// ---- Render sem GPU ----
+	{
+		for (int nThreads : {0, 1}) {
+			RasterizadorCPU cpu(LARGURA_TELA, ALTURA_TELA, nThreads);
+			GLuint texID = cpu.carregarTextura(assets + "tilesets/" + mapa.tilesetFile);
+			if (!texID) {
+				// Sem o asset: um tileset liso tem o mesmo custo de rasterização
+				vector<unsigned char> liso((size_t)mapa.nTiles * 32 * 32 * 4, 200);
+				texID = cpu.adicionarTextura(liso.data(), mapa.nTiles * 32, 32);
+			}
+			string sufixo = nThreads == 1 ? "-1thread" : "";
+			vec2 centro = centroTile(lado / 2, lado / 2);
+			for (float zoom : {1.0f, 0.25f}) {
+				char nome[64];
+				snprintf(nome, sizeof(nome), "render/cpu-mapa-zoom%g%s", zoom, sufixo.c_str());
+				bench.medir(nome, [&] { return desenharMapaCPU(cpu, mapa, texID, centro, zoom); });
+			}
+		}
+	}
+
+	cout << "verificação: " << bench.verificacao() << endl;
+
+	if (!arquivoJson.empty()) {
+		if (!bench.salvarJson(arquivoJson, rotulo)) {
+			cerr << "Não foi possível gravar " << arquivoJson << endl;
+			return 1;
+		}
+		cout << "Resultados em " << arquivoJson << endl;
+	}
+	return 0;
+}
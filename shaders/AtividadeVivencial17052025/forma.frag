@@ -0,0 +1,9 @@
+#version 400
+in vec3 vCor;
+uniform vec4 inputColor;
+uniform bool usarInputColor; // contorno de seleção; senão a cor vem do vértice
+out vec4 color;
+void main()
+{
+	color = usarInputColor ? inputColor : vec4(vCor, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 400
+in vec2 mundo;
+out vec4 color;
+uniform usampler2D mapa;         // IDs dos tiles: x = coluna (j), y = linha (i)
+uniform sampler2DArray camadas;  // tileset, um tile por camada
+uniform vec2 origem;             // canto do tile [0][0]
+uniform vec2 tamTile;            // largura e altura do losango
+
+void main()
+{
+	// Coordenadas em unidades de meio tile relativas ao centro do tile [0][0]:
+	// o centro do tile [i][j] fica em (j - i, j + i)
+	vec2 p = (mundo - origem) / (tamTile * 0.5) - vec2(1.0);
+	vec2 ji = vec2(p.x + p.y, p.y - p.x) * 0.5;
+	ivec2 celula = ivec2(floor(ji + 0.5));
+
+	ivec2 dim = textureSize(mapa, 0);
+	if (celula.x < 0 || celula.y < 0 || celula.x >= dim.x || celula.y >= dim.y)
+		discard;
+
+	uint id = texelFetch(mapa, celula, 0).r;
+
+	// Posição dentro do quad do tile, em [0, 1], igual às coordenadas de setupTile
+	vec2 local = (p - vec2(celula.x - celula.y, celula.x + celula.y) + 1.0) * 0.5;
+	color = textureLod(camadas, vec3(local.x, 1.0 - local.y, float(id)), 0.0);
+}
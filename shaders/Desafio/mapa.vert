@@ -0,0 +1,18 @@
+#version 400
+layout (location = 0) in vec3 position;
+out vec2 mundo;
+
+layout (std140) uniform ConstantesFrame {
+	mat4 projection;
+	mat4 view;
+	vec4 viewport;
+	float tempo;
+};
+
+uniform mat4 model;
+void main()
+{
+	vec4 p = model * vec4(position, 1.0);
+	mundo = p.xy;
+	gl_Position = projection * view * p;
+}
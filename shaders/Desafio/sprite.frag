@@ -0,0 +1,14 @@
+#version 400
+in vec2 tex_coord;
+flat in int camada;
+out vec4 color;
+uniform sampler2D tex_buff;
+uniform sampler2DArray camadas; // tileset com um tile por camada
+
+void main()
+{
+	if (camada >= 0)
+		color = texture(camadas, vec3(tex_coord, camada));
+	else
+		color = texture(tex_buff,tex_coord);
+}
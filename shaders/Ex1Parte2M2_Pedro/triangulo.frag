@@ -0,0 +1,7 @@
+#version 400
+in vec3 vCor;
+out vec4 color;
+void main()
+{
+	color = vec4(vCor, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 cor;
+uniform mat4 projection;
+uniform mat4 model;
+out vec3 vCor;
+void main()
+{
+	vCor = cor;
+	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
+}
@@ -0,0 +1,31 @@
+#version 400 core
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+layout (std140) uniform ConstantesFrame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    float tempo;
+};
+
+// Três texels por sprite, no formato do RenderizadorGL: colunas x e y da model;
+// translação e deslocamento da textura (o parallax das camadas); camada (não usada)
+uniform samplerBuffer quads;
+uniform int primeiroQuad;
+
+void main()
+{
+    int k = 3 * (primeiroQuad + gl_InstanceID);
+    vec4 eixos = texelFetch(quads, k);
+    vec4 extra = texelFetch(quads, k + 1);
+    mat4 model = mat4(vec4(eixos.xy, 0.0, 0.0),
+                      vec4(eixos.zw, 0.0, 0.0),
+                      vec4(0.0, 0.0, 1.0, 0.0),
+                      vec4(extra.xy, 0.0, 1.0));
+
+    TexCoords = texCoords + extra.zw;
+    gl_Position = projection * view * model * vec4(position, 1.0);
+}
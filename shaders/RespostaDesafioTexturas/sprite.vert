@@ -0,0 +1,34 @@
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec2 texc;
+
+out vec3 vColor;
+out vec2 tex_coord;
+
+layout (std140) uniform ConstantesFrame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    float tempo;
+};
+
+// Três texels por sprite, no formato do RenderizadorGL (o mesmo do
+// shaders/Desafio/sprite.vert), indexados por primeiroQuad + gl_InstanceID
+uniform samplerBuffer quads;
+uniform int primeiroQuad;
+
+void main()
+{
+    int k = 3 * (primeiroQuad + gl_InstanceID);
+    vec4 eixos = texelFetch(quads, k);
+    vec4 extra = texelFetch(quads, k + 1);
+    mat4 model = mat4(vec4(eixos.xy, 0.0, 0.0),
+                      vec4(eixos.zw, 0.0, 0.0),
+                      vec4(0.0, 0.0, 1.0, 0.0),
+                      vec4(extra.xy, 0.0, 1.0));
+
+    vColor = color;
+    tex_coord = vec2(texc.s, 1.0 - texc.t) + extra.zw; // a imagem é carregada com a primeira linha em t = 0
+    gl_Position = projection * view * model * vec4(position, 1.0);
+}
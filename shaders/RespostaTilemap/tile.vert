@@ -0,0 +1,30 @@
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+out vec2 tex_coord;
+
+layout (std140) uniform ConstantesFrame {
+	mat4 projection;
+	mat4 view;
+	vec4 viewport;
+	float tempo;
+};
+
+// Três texels por tile, no formato do RenderizadorGL: colunas x e y da model;
+// translação e deslocamento no tileset; camada (não usada aqui)
+uniform samplerBuffer quads;
+uniform int primeiroQuad;
+
+void main()
+{
+	int k = 3 * (primeiroQuad + gl_InstanceID);
+	vec4 eixos = texelFetch(quads, k);
+	vec4 extra = texelFetch(quads, k + 1);
+	mat4 model = mat4(vec4(eixos.xy, 0.0, 0.0),
+					  vec4(eixos.zw, 0.0, 0.0),
+					  vec4(0.0, 0.0, 1.0, 0.0),
+					  vec4(extra.xy, 0.0, 1.0));
+
+	tex_coord = vec2(texc.s, 1.0 - texc.t) + extra.zw;
+	gl_Position = projection * view * model * vec4(position, 1.0);
+}
@@ -0,0 +1,221 @@
+/* Gerador procedural de mapas isométricos para testes de carga do tilemap
+ *
+ * Uso:
+ *   GeradorMapa <saida> <largura> <altura> [opções]
+ *
+ * Opções:
+ *   --semente <n>     semente do gerador (padrão 1); a mesma semente gera o mesmo mapa
+ *   --hazard <f>      fração de tiles de perigo (lava), em lagos contínuos (padrão 0.03)
+ *   --moedas <f>      fração de tiles coletáveis espalhados (padrão 0.002)
+ *   --troca <f>       fração de tiles que trocam ao pisar, em manchas (padrão 0.05)
+ *   --escala <n>      tamanho em tiles das feições do ruído (padrão 48)
+ *   --binario         escreve no formato binário .pgmap em vez do texto de map.txt
+ *
+ * O mapa usa o mesmo tileset e as mesmas propriedades de map.txt:
+ *   0, 1, 2 -> terreno comum    3, 5 -> perigo    4 -> troca    6 -> moeda
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <MapaIso.h>
+
+using namespace std;
+
+// Hash inteiro (variação do lowbias32) usado para gerar os valores da grade de ruído
+static uint32_t hash32(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
+
+static float valorGrade(uint32_t semente, int x, int y)
+{
+	uint32_t h = hash32(semente ^ hash32((uint32_t)x * 0x9E3779B1U ^ hash32((uint32_t)y)));
+	return (h & 0xFFFFFF) / (float)0xFFFFFF;
+}
+
+// Value noise com interpolação suave (smoothstep) entre os pontos da grade
+static float ruido(uint32_t semente, float x, float y)
+{
+	int x0 = (int)floor(x), y0 = (int)floor(y);
+	float fx = x - x0, fy = y - y0;
+	float sx = fx * fx * (3.0f - 2.0f * fx);
+	float sy = fy * fy * (3.0f - 2.0f * fy);
+
+	float a = valorGrade(semente, x0, y0);
+	float b = valorGrade(semente, x0 + 1, y0);
+	float c = valorGrade(semente, x0, y0 + 1);
+	float d = valorGrade(semente, x0 + 1, y0 + 1);
+
+	float topo = a + (b - a) * sx;
+	float base = c + (d - c) * sx;
+	return topo + (base - topo) * sy;
+}
+
+// Soma de 4 oitavas (fBm), normalizada para [0, 1]
+static float fbm(uint32_t semente, float x, float y)
+{
+	float soma = 0.0f, amplitude = 0.5f, total = 0.0f;
+	for (int o = 0; o < 4; o++)
+	{
+		soma += amplitude * ruido(semente + o * 1013, x, y);
+		total += amplitude;
+		x *= 2.0f;
+		y *= 2.0f;
+		amplitude *= 0.5f;
+	}
+	return soma / total;
+}
+
+// Limiar acima do qual fica aproximadamente a fração pedida dos valores do campo,
+// estimado por amostragem (determinística) do próprio campo
+static float limiarParaFracao(uint32_t semente, float escala, int largura, int altura, float fracao)
+{
+	if (fracao <= 0.0f)
+		return 2.0f;
+
+	const int nAmostras = 1 << 16;
+	vector<float> amostras(nAmostras);
+	for (int k = 0; k < nAmostras; k++)
+	{
+		uint32_t h = hash32(semente * 31u + k);
+		int i = h % altura;
+		int j = hash32(h) % largura;
+		amostras[k] = fbm(semente, j / escala, i / escala);
+	}
+	int idx = std::min(nAmostras - 1, (int)((1.0f - fracao) * nAmostras));
+	nth_element(amostras.begin(), amostras.begin() + idx, amostras.end());
+	return amostras[idx];
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 4)
+	{
+		cerr << "Uso: " << argv[0] << " <saida> <largura> <altura> [--semente n] [--hazard f] "
+			 << "[--moedas f] [--troca f] [--escala n] [--binario]" << endl;
+		return 1;
+	}
+
+	string saida = argv[1];
+	int largura = atoi(argv[2]);
+	int altura = atoi(argv[3]);
+	uint32_t semente = 1;
+	float fracaoHazard = 0.03f, fracaoMoedas = 0.002f, fracaoTroca = 0.05f;
+	float escala = 48.0f;
+	bool binario = false;
+
+	for (int i = 4; i < argc; i++)
+	{
+		string arg = argv[i];
+		bool temValor = i + 1 < argc;
+		if (arg == "--semente" && temValor) semente = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (arg == "--hazard" && temValor) fracaoHazard = (float)atof(argv[++i]);
+		else if (arg == "--moedas" && temValor) fracaoMoedas = (float)atof(argv[++i]);
+		else if (arg == "--troca" && temValor) fracaoTroca = (float)atof(argv[++i]);
+		else if (arg == "--escala" && temValor) escala = (float)atof(argv[++i]);
+		else if (arg == "--binario") binario = true;
+		else
+		{
+			cerr << "Opção desconhecida: " << arg << endl;
+			return 1;
+		}
+	}
+
+	if (largura <= 0 || altura <= 0)
+	{
+		cerr << "Dimensões inválidas: " << largura << " x " << altura << endl;
+		return 1;
+	}
+
+	auto inicio = chrono::steady_clock::now();
+
+	MapaIso mapa;
+	mapa.tilesetFile = "tilesetIso.png";
+	mapa.nTiles = 7;
+	mapa.tileWidth = 16;
+	mapa.tileHeight = 32;
+	mapa.largura = largura;
+	mapa.altura = altura;
+	mapa.tiles.resize((size_t)largura * altura);
+	mapa.props = {
+		{false, false, false}, // 0 terreno
+		{false, false, false}, // 1 terreno
+		{false, false, false}, // 2 terreno
+		{false, true, false},  // 3 perigo
+		{true, false, false},  // 4 troca
+		{false, true, false},  // 5 perigo
+		{false, false, true},  // 6 moeda
+	};
+
+	// Campos independentes: relevo (tipo de terreno), lava e manchas de troca
+	uint32_t sRelevo = hash32(semente), sLava = hash32(semente + 1), sTroca = hash32(semente + 2);
+	float limiarLava = limiarParaFracao(sLava, escala, largura, altura, fracaoHazard);
+	float limiarTroca = limiarParaFracao(sTroca, escala * 0.5f, largura, altura, fracaoTroca);
+	uint32_t limiarMoeda = (uint32_t)(std::min(1.0f, std::max(0.0f, fracaoMoedas)) * 4294967295.0);
+
+	size_t contagem[7] = {};
+	for (int i = 0; i < altura; i++)
+	{
+		for (int j = 0; j < largura; j++)
+		{
+			float x = j / escala, y = i / escala;
+			uint16_t id;
+
+			float lava = fbm(sLava, x, y);
+			if (lava >= limiarLava)
+			{
+				// Borda do lago (3) e centro (5)
+				id = lava >= limiarLava + 0.04f ? 5 : 3;
+			}
+			else if (fbm(sTroca, 2.0f * x, 2.0f * y) >= limiarTroca)
+			{
+				id = 4;
+			}
+			else if (hash32(semente ^ hash32((uint32_t)((uint64_t)i * largura + j))) < limiarMoeda)
+			{
+				id = 6;
+			}
+			else
+			{
+				float relevo = fbm(sRelevo, x, y);
+				id = relevo < 0.45f ? 0 : (relevo < 0.6f ? 1 : 2);
+			}
+
+			mapa.at(i, j) = id;
+		}
+	}
+
+	// O jogador começa em [0,0]: garante que ele não nasce sobre lava
+	mapa.at(0, 0) = 0;
+
+	for (uint16_t id : mapa.tiles)
+		contagem[id]++;
+
+	bool ok = binario ? salvarMapaBinario(saida, mapa) : salvarMapaTexto(saida, mapa);
+	if (!ok)
+	{
+		cerr << "Erro ao escrever " << saida << endl;
+		return 1;
+	}
+
+	double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	double total = (double)mapa.tiles.size();
+	cout << "Mapa " << largura << "x" << altura << " (semente " << semente << ") escrito em " << saida
+		 << " em " << segundos << " s" << endl;
+	cout << "  perigo: " << (contagem[3] + contagem[5]) / total * 100.0 << "%"
+		 << "  troca: " << contagem[4] / total * 100.0 << "%"
+		 << "  moedas: " << contagem[6] << endl;
+	return 0;
+}
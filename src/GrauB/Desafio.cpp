@@ -5,6 +5,9 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 
 using namespace std;
 
@@ -14,10 +17,6 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 //GLM
 #include <glm/glm.hpp> 
 #include <glm/gtc/matrix_transform.hpp>
@@ -25,6 +24,19 @@ using namespace std;
 
 using namespace glm;
 
+// Fila de eventos de entrada, gravação/reprodução e relatório de frames
+#include <InputQueue.h>
+#include <InputLog.h>
+#include <FrameReport.h>
+
+// Carregamento de mapas (texto ou binário)
+#include <MapaIso.h>
+#include <Picking.h>
+#include <CullingIso.h>
+
+// Shaders (de arquivo, com recarga e cache), texturas, quads de sprite/tile e FPS
+#include <Engine.h>
+
 struct Sprite {
 	GLuint VAO;
 	GLuint texID;
@@ -37,7 +49,9 @@ struct Sprite {
 	
 struct Tile {
 	GLuint VAO;
+	const GLfloat *vertices; // o mesmo quad do VAO, para o rasterizador de CPU
 	GLuint texID;
+	bool texArray;           // texID é uma GL_TEXTURE_2D_ARRAY com o tile na camada iTile
 	int iTile;
 	vec3 position;
 	vec3 dimensions;
@@ -45,47 +59,51 @@ struct Tile {
 };
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
-
-int setupShader();
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
-int setupTile(int nTiles, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
-void desenharMapa(GLuint shaderID);
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
+void processarEntrada(GLFWwindow *window);
+void passoSimulacao(GLFWwindow *window, int acao);
+void cliqueNoMapa(GLFWwindow *window, double x, double y);
+
+void desenharMapa();
+void desenharMapaShader(GLuint shaderID);
+void desenharMapaIndireto(GLuint shaderID);
+void desenharMapaCache(GLuint shaderID);
+void desenharMapaImpostores(GLuint shaderID);
+vec4 limitesChunkCache(int ci, int cj, float x0, float y0, float tileW, float tileH);
+void desenharJogador(float x, float y);
+QuadTexturizado quadJogador(float x, float y);
+QuadTexturizado quadTile(int i, int j, float x0, float y0);
+void desenharCena(GLuint shaderID);
+void atualizarCamera();
+void criarTileset(GLuint texID, GLuint VAO, bool texArray);
+int executarCPU(const OpcoesSessao &opcoes, const string &arquivoMapa, const string &arquivoSaida);
+void origemMapa(float &x0, float &y0);
+bool setupMapaTextura();
+void configurarShaderMapa();
+void atualizarTileGPU(int i, int j);
+void benchmarkMapa(GLFWwindow *window, GLuint shaderID, int nFrames);
+void registrarContadoresGL();
+void registrarAlocacoesFrame(const ContagemAlocacoes &antes);
+int resultadoAlocacoes();
 
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-const GLchar *vertexShaderSource = R"(
- #version 400
- layout (location = 0) in vec3 position;
- layout (location = 1) in vec2 texc;
- out vec2 tex_coord;
- uniform mat4 model;
- uniform mat4 projection;
- void main()
- {
-	tex_coord = vec2(texc.s, 1.0 - texc.t);
-	gl_Position = projection * model * vec4(position, 1.0);
- }
- )";
-
-const GLchar *fragmentShaderSource = R"(
- #version 400
- in vec2 tex_coord;
- out vec4 color;
- uniform sampler2D tex_buff;
- uniform vec2 offsetTex;
-
- void main()
- {
-	 color = texture(tex_buff,tex_coord + offsetTex);
- }
- )";
+// Shaders em arquivos (shaders/Desafio), recarregados quando são salvos:
+// sprite = tiles e jogador; mapa = modo de desenho do mapa inteiro por um único quad
+// (o fragment shader descobre em qual tile cada pixel cai e busca o ID na textura do
+// mapa, então o custo de vértices não depende do tamanho do mapa)
+const string DIR_SHADERS = "../shaders/Desafio/";
+ProgramaShader shaderSprite, shaderMapa;
 
 string tilesetFile;
 int nTiles;
 int tileWidth, tileHeight;
 int mapWidth, mapHeight;
-vector<vector<int>> mapData;
+vector<uint16_t> mapData;
+
+// mapData é armazenado linha a linha: o tile da linha i, coluna j fica em i * mapWidth + j
+inline uint16_t &tileMapa(int i, int j) { return mapData[(size_t)i * mapWidth + j]; }
 
 int playerX;
 int playerY;
@@ -93,92 +111,207 @@ int playerY;
 vector <Tile> tileset;
 
 Sprite vampirao;
+// Frames do vampirão recortados pelo alfa (Common/engine/SpriteSheet.h)
+SpriteSheet folhaVampirao;
 
-struct TileProperties {
-    bool isChangeTile;
-    bool isHazard;
-    bool isCollectible;
-};
+// Destino do desenho do mapa e do jogador: OpenGL, ou o rasterizador de CPU com --cpu
+RenderizadorGL renderizadorGL;
+Renderizador *renderizador = &renderizadorGL;
+bool fimDeJogo = false;
+
+// Dados que só valem durante o frame (os quads do mapa), reiniciada a cada frame
+ArenaFrame arenaFrame(1 << 20);
+
+// Redesenho só quando algo muda (Common/engine/Tempo.h); os callbacks de entrada pedem
+AgendadorRedesenho agendador;
+
+// --checar-alocacoes: passado o aquecimento, nenhum frame pode alocar no heap
+bool checarAlocacoes = false;
+const uint32_t FRAMES_AQUECIMENTO = 120;
+uint32_t framesComAlocacao = 0;
 
 vector<TileProperties> tileProperties;
 
+// Câmera: ponto do mundo que fica no centro da janela e fator de zoom. Enquanto o
+// mapa cabe na janela a câmera fica parada; nos mapas maiores ela segue o jogador.
+vec2 cameraCentro = vec2(WIDTH / 2.0f, HEIGHT / 2.0f);
+float zoom = 1.0f;
+mat4 projecaoCamera;
+
+// projection, view, viewport e tempo num uniform buffer compartilhado pelos dois
+// programas (Common/engine/ConstantesFrame.h), enviado uma vez por frame
+BlocoConstantesFrame constantesFrame;
+ConstantesFrame constantes;
+
+// Modos de desenho do mapa (tecla M alterna entre os disponíveis): geometria por
+// tile com culling na CPU, um quad com o shader de lookup (shaders/Desafio/mapa.frag),
+// chunks recortados por compute shader e desenhados com multi-draw indirect, ou
+// chunks renderizados uma vez em textura e compostos como um quad cada
+enum ModoMapa { MAPA_GEOMETRIA, MAPA_SHADER, MAPA_INDIRETO, MAPA_CACHE, N_MODOS_MAPA };
+ModoMapa modoMapa = MAPA_GEOMETRIA;
+GLuint mapaShaderID = 0;
+GLuint mapaTexID = 0;
+GLuint mapaVAO = 0;
+
+// Modo indireto (Common/engine/ChunksMapaGPU.h), só com OpenGL 4.3
+ChunksMapaGPU chunksMapa;
+bool chunksMapaProntos = false;
+
+// Modo por cache (Common/engine/CacheChunksMapa.h): chunks de TAM_CHUNK_CACHE x
+// TAM_CHUNK_CACHE tiles, refeitos só quando um tile muda ou o zoom muda
+const int TAM_CHUNK_CACHE = 16;
+CacheChunksMapa cacheChunks;
+bool cacheChunksPronto = false;
+size_t orcamentoCacheMB = 64;
+int chunksCachePorLinha = 0;
+
+// Nível de detalhe (Common/engine/ImpostoresMapa.h): abaixo de zoomLOD os modos por
+// tile dão lugar às células pré-renderizadas do mapa
+ImpostoresMapa impostores;
+float zoomLOD = 0.4f;
+size_t orcamentoLODMB = 64;
+
+bool modoMapaDisponivel(ModoMapa modo);
+const char *nomeModoMapa(ModoMapa modo);
+
+const float ZOOM_MIN = 0.1f, ZOOM_MAX = 8.0f;
+
 int totalMoedas = 0;
 int moedasColetadas = 0;
 
-void loadMapConfig(const string& filename) {
-    ifstream file(filename);
-
-    if (!file) {
-        cerr << "Erro ao abrir arquivo de configuração: " << filename << endl;
-        exit(1);
-    }
-
-    string line;
-    
-    getline(file, line);
-    stringstream ss1(line);
-    ss1 >> tilesetFile >> nTiles >> tileWidth >> tileHeight;
+// Ações do jogo: o callback de teclado só enfileira eventos, e o passo de simulação
+// traduz cada evento em uma ação através da tabela de bindings abaixo
+enum Acao {
+	ACAO_NENHUMA = -1,
+	ACAO_NORTE, ACAO_SUL, ACAO_OESTE, ACAO_LESTE,
+	ACAO_NOROESTE, ACAO_NORDESTE, ACAO_SUDOESTE, ACAO_SUDESTE,
+	ACAO_ZOOM_MAIS, ACAO_ZOOM_MENOS,
+	ACAO_ALTERNAR_MODO_MAPA
+};
 
-    getline(file, line);
-    stringstream ss2(line);
-    ss2 >> mapWidth >> mapHeight;
+struct AcaoMovimento {
+	int dX, dY;
+	int iAnimation;
+};
 
-	playerX = 0;
-    playerY = 0;
+// Deslocamento na matriz e linha do spritesheet de cada ação de movimento
+const AcaoMovimento movimentos[] = {
+	{-1,  0, 2}, // ACAO_NORTE
+	{ 1,  0, 1}, // ACAO_SUL
+	{ 0, -1, 3}, // ACAO_OESTE
+	{ 0,  1, 0}, // ACAO_LESTE
+	{-1, -1, 2}, // ACAO_NOROESTE
+	{-1,  1, 2}, // ACAO_NORDESTE
+	{ 1, -1, 1}, // ACAO_SUDOESTE
+	{ 1,  1, 1}, // ACAO_SUDESTE
+};
 
-    mapData.resize(mapHeight, vector<int>(mapWidth));
+struct BindingTecla {
+	int key;
+	Acao acao;
+};
 
-    for (int i = 0; i < mapHeight; i++) {
-        getline(file, line);
-        stringstream ss(line);
-        for (int j = 0; j < mapWidth; j++) {
-            ss >> mapData[i][j];
-        }
-    }
+vector<BindingTecla> bindings = {
+	{GLFW_KEY_W, ACAO_NORTE},
+	{GLFW_KEY_S, ACAO_SUL},
+	{GLFW_KEY_A, ACAO_OESTE},
+	{GLFW_KEY_D, ACAO_LESTE},
+	{GLFW_KEY_Q, ACAO_NOROESTE},
+	{GLFW_KEY_E, ACAO_NORDESTE},
+	{GLFW_KEY_Z, ACAO_SUDOESTE},
+	{GLFW_KEY_C, ACAO_SUDESTE},
+	{GLFW_KEY_EQUAL, ACAO_ZOOM_MAIS},
+	{GLFW_KEY_KP_ADD, ACAO_ZOOM_MAIS},
+	{GLFW_KEY_MINUS, ACAO_ZOOM_MENOS},
+	{GLFW_KEY_KP_SUBTRACT, ACAO_ZOOM_MENOS},
+	{GLFW_KEY_M, ACAO_ALTERNAR_MODO_MAPA},
+};
 
-	while (getline(file, line)) {
-		if (line == "--") break;
-	}
+InputQueue<256> filaEntrada;
+SessaoEntrada sessao;
+FrameReport relatorio;
 
-	getline(file, line);
-	if (line != "TileProperties") {
-		cerr << "Erro: seção TileProperties não encontrada" << endl;
+void loadMapConfig(const string& filename) {
+	MapaIso mapa;
+	if (!carregarMapa(filename, mapa)) {
 		exit(1);
 	}
 
-	tileProperties.clear();
+	tilesetFile = mapa.tilesetFile;
+	nTiles = mapa.nTiles;
+	tileWidth = mapa.tileWidth;
+	tileHeight = mapa.tileHeight;
+	mapWidth = mapa.largura;
+	mapHeight = mapa.altura;
+	mapData = std::move(mapa.tiles);
+	tileProperties = std::move(mapa.props);
 
-	while (getline(file, line)) {
-		if (line.empty()) continue;
+	playerX = 0;
+	playerY = 0;
 
-		TileProperties props;
-		int changeTile, hazard, collectible;
-		stringstream ss(line);
-		ss >> changeTile >> hazard >> collectible;
+	totalMoedas = 0;
+	for (uint16_t id : mapData) {
+		if (tileProperties[id].isCollectible) {
+			totalMoedas++;
+		}
+	}
+	cout << "Mapa " << mapWidth << "x" << mapHeight << " - Total de moedas no mapa: " << totalMoedas << endl;
+}
 
-		props.isChangeTile = (changeTile != 0);
-		props.isHazard = (hazard != 0);
-		props.isCollectible = (collectible != 0);
+int main(int argc, char **argv)
+{
+	// --gravar/--reproduzir/--relatorio/--headless (ver Common/InputLog.h)
+	OpcoesSessao opcoes = lerOpcoesSessao(argc, argv);
+	if (!sessao.iniciar(opcoes, 1.0f / 60.0f))
+		return -1;
 
-		tileProperties.push_back(props);
+	// --mapa <arquivo>: mapa alternativo (texto ou .pgmap, ver src/Ferramentas/GeradorMapa.cpp)
+	// --modo-shader: começa com o mapa desenhado pelo shader de lookup (tecla M alterna)
+	// --modo-indireto: começa com os chunks recortados na GPU (precisa de OpenGL 4.3)
+	// --modo-cache: começa com os chunks em textura; --cache-mb <n>: orçamento das texturas
+	// --lod-zoom <z>: zoom abaixo do qual o mapa é desenhado pelos impostores (0 desliga);
+	// --lod-mb <n>: orçamento dos atlas dos impostores
+	// --bench-mapa <n>: mede n frames de cada modo de desenho do mapa e sai
+	// --cpu <arquivo.png>: desenha sem janela nem GPU (RasterizadorCPU) e grava o frame
+	// --contar-gl: chamadas OpenGL por frame no terminal (a cada segundo) e no --relatorio;
+	// --verificar-gl também confere glGetError depois de cada chamada. As duas precisam
+	// da engine compilada com -DPG_INSTRUMENTAR_GL=ON (Common/engine/InstrumentacaoGL.h)
+	// --continuo: desenha a cada volta do loop, em vez de só quando algo muda (a
+	// reprodução de sessões é sempre contínua)
+	// --checar-alocacoes: depois de FRAMES_AQUECIMENTO frames, conta os frames que alocaram
+	// no heap e sai com código 1 se houver algum (para usar com --reproduzir no CI)
+	string arquivoMapa = "../map.txt";
+	string arquivoCPU;
+	int framesBenchmark = 0;
+	bool contarGL = false, verificarGL = false, continuo = false;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--mapa" && i + 1 < argc) arquivoMapa = argv[++i];
+		else if (arg == "--bench-mapa" && i + 1 < argc) framesBenchmark = atoi(argv[++i]);
+		else if (arg == "--cpu" && i + 1 < argc) arquivoCPU = argv[++i];
+		else if (arg == "--modo-shader") modoMapa = MAPA_SHADER;
+		else if (arg == "--modo-indireto") modoMapa = MAPA_INDIRETO;
+		else if (arg == "--modo-cache") modoMapa = MAPA_CACHE;
+		else if (arg == "--cache-mb" && i + 1 < argc) orcamentoCacheMB = (size_t)max(1, atoi(argv[++i]));
+		else if (arg == "--lod-zoom" && i + 1 < argc) zoomLOD = (float)atof(argv[++i]);
+		else if (arg == "--lod-mb" && i + 1 < argc) orcamentoLODMB = (size_t)max(1, atoi(argv[++i]));
+		else if (arg == "--contar-gl") contarGL = true;
+		else if (arg == "--verificar-gl") contarGL = verificarGL = true;
+		else if (arg == "--checar-alocacoes") checarAlocacoes = true;
+		else if (arg == "--continuo") continuo = true;
 	}
 
-    file.close();
+	// Sem crescer o vetor de tempos no meio da reprodução
+	if (sessao.reproduzindo())
+		relatorio.reservar(sessao.framesGravados());
 
-	for (int i = 0; i < mapHeight; i++) {
-		for (int j = 0; j < mapWidth; j++) {
-			if (tileProperties[mapData[i][j]].isCollectible) {
-				totalMoedas++;
-			}
-		}
-	}
-	cout << "Total de moedas no mapa: " << totalMoedas << endl;
-}
+	if (!arquivoCPU.empty())
+		return executarCPU(opcoes, arquivoMapa, arquivoCPU);
 
-int main()
-{
 	glfwInit();
 	glfwWindowHint(GLFW_SAMPLES, 8);
+	if (opcoes.headless)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
 	if (!window)
 	{
@@ -188,7 +321,13 @@ int main()
 	}
 	glfwMakeContextCurrent(window);
 
+	// Na reprodução o vsync limitaria a medição de tempo de frame
+	if (sessao.reproduzindo())
+		glfwSwapInterval(0);
+
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetScrollCallback(window, scroll_callback);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
 
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
 	{
@@ -196,6 +335,13 @@ int main()
 		return -1;
 	}
 
+	if (contarGL) {
+		if (INSTRUMENTACAO_GL)
+			instalarInstrumentacaoGL(verificarGL);
+		else
+			cerr << "--contar-gl: compile com -DPG_INSTRUMENTAR_GL=ON (fora do Release)" << endl;
+	}
+
 	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
 	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
 	cout << "Renderer: " << renderer << endl;
@@ -205,35 +351,69 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	GLuint shaderID = setupShader();
+	if (!shaderSprite.carregar(DIR_SHADERS + "sprite.vert", DIR_SHADERS + "sprite.frag") ||
+		!shaderMapa.carregar(DIR_SHADERS + "mapa.vert", DIR_SHADERS + "mapa.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shaderSprite.id();
+	mapaShaderID = shaderMapa.id();
 
 	int imgWidth, imgHeight;
 
-	loadMapConfig("../map.txt");
-	GLuint texID = loadTexture("../assets/tilesets/" + tilesetFile, imgWidth, imgHeight);
+	constantesFrame.init();
+	constantes.viewport = vec4(0.0f, 0.0f, width, height);
+
+	loadMapConfig(arquivoMapa);
+	// Um tile por camada: sem offsetTex e sem vazamento entre tiles vizinhos na filtragem
+	GLuint texID = loadTextureArray("../assets/tilesets/" + tilesetFile, nTiles, imgWidth, imgHeight);
+	if (!texID)
+	{
+		glfwTerminate();
+		return -1;
+	}
 
 	vampirao.nAnimations = 4;
 	vampirao.nFrames = 6;
-	vampirao.VAO = setupSprite(vampirao.nAnimations,vampirao.nFrames,vampirao.ds,vampirao.dt);
+	folhaVampirao.importar("../assets/sprites/Vampires1_Walk_full.png", vampirao.nAnimations, vampirao.nFrames);
+	folhaVampirao.relatorio(cout);
+	vampirao.VAO = folhaVampirao.vao(OrigemQuad::Centro);
 	vampirao.position = vec3(0.0, 0.0, 0.0);
 	vampirao.dimensions = vec3(tileWidth, tileHeight, 1.0);
-	vampirao.texID = loadTexture("../assets/sprites/Vampires1_Walk_full.png", imgWidth, imgHeight);
+	vampirao.texID = folhaVampirao.textura();
 	vampirao.iAnimation = 0;
 	vampirao.iFrame = 0;
 
-	for (int i = 0; i < nTiles; i++){
-		Tile tile;
-		tile.dimensions = vec3(tileHeight, tileWidth,1.0);
-		tile.iTile = i;
-		tile.texID = texID;
-		tile.VAO = setupTile(nTiles, tile.ds,tile.dt);
-		tileset.push_back(tile);
+	// Com a textura array o quad do tile cobre a camada inteira (s de 0 a 1)
+	float ds, dt;
+	criarTileset(texID, setupTile(1, ds, dt), true);
+
+	setupMapaTextura();
+	if (ChunksMapaGPU::suportado()) {
+		float x0, y0;
+		origemMapa(x0, y0);
+		chunksMapaProntos = chunksMapa.init(mapData.data(), mapHeight, mapWidth, vec2(x0, y0),
+											vec2(tileset[0].dimensions.x, tileset[0].dimensions.y));
 	}
+	else
+		cout << "OpenGL 4.3 indisponível: modo indireto desativado (culling do mapa na CPU)" << endl;
+	chunksCachePorLinha = (mapWidth + TAM_CHUNK_CACHE - 1) / TAM_CHUNK_CACHE;
+	int chunksCachePorColuna = (mapHeight + TAM_CHUNK_CACHE - 1) / TAM_CHUNK_CACHE;
+	cacheChunksPronto = cacheChunks.init(chunksCachePorLinha * chunksCachePorColuna, orcamentoCacheMB << 20);
+	if (zoomLOD > 0.0f) {
+		float x0, y0;
+		origemMapa(x0, y0);
+		impostores.init(mapData.data(), mapHeight, mapWidth, vec2(x0, y0),
+						vec2(tileset[0].dimensions.x, tileset[0].dimensions.y), texID, zoomLOD, orcamentoLODMB << 20);
+	}
+	if (!modoMapaDisponivel(modoMapa))
+		modoMapa = MAPA_GEOMETRIA;
 
 	glUseProgram(shaderID);
 
-	double prev_s = glfwGetTime();
-	double title_countdown_s = 0.1;
+	ContadorFPS contadorFPS;
 
 	float colorValue = 0.0;
 
@@ -241,46 +421,71 @@ int main()
 
 	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
 
-	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
-
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_ALWAYS);
 
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	if (framesBenchmark > 0) {
+		benchmarkMapa(window, shaderID, framesBenchmark);
+		glfwTerminate();
+		return 0;
+	}
+
 	double lastTime = 0.0;
 	double deltaT = 0.0;
 	double currTime = glfwGetTime();
 	double FPS = 12.0;
+	double proximoResumoGL = 0.0;
+
+	// O jogo é por turnos: fora da reprodução, o loop dorme até uma tecla, um clique,
+	// a roda do mouse, um evento da janela ou o próximo frame da animação do vampirão
+	bool porEventos = !continuo && !sessao.reproduzindo();
+	if (porEventos)
+		agendador.instalar(window);
 
 	// Loop da aplicação - "game loop"
-	while (!glfwWindowShouldClose(window))
+	while (!glfwWindowShouldClose(window) && !sessao.terminou())
 	{
-		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
-		{
-			double curr_s = glfwGetTime();		// Obtém o tempo atual.
-			double elapsed_s = curr_s - prev_s; // Calcula o tempo decorrido desde o último frame.
-			prev_s = curr_s;					// Atualiza o "tempo anterior" para o próximo frame.
+		bool desenhar = true;
+		if (porEventos) {
+			desenhar = agendador.esperar();
+			agendador.atualizarTitulo(window, "Ola Triangulo! -- Rossana");
+		}
+		else {
+			// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+			glfwPollEvents();
+		}
 
-			// Exibe o FPS, mas não a cada frame, para evitar oscilações excessivas.
-			title_countdown_s -= elapsed_s;
-			if (title_countdown_s <= 0.0 && elapsed_s > 0.0)
-			{
-				double fps = 1.0 / elapsed_s; // Calcula o FPS com base no tempo decorrido.
+		// Shaders editados em disco: o programa novo recebe de volta os uniforms fixos
+		if (shaderSprite.recarregarSeMudou())
+		{
+			shaderID = shaderSprite.id();
+			glUseProgram(shaderID);
+			glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+			desenhar = true;
+		}
+		if (shaderMapa.recarregarSeMudou())
+		{
+			mapaShaderID = shaderMapa.id();
+			configurarShaderMapa();
+			glUseProgram(shaderID);
+			desenhar = true;
+		}
+		if (!desenhar)
+			continue;
 
-				// Cria uma string e define o FPS como título da janela.
-				char tmp[256];
-				sprintf(tmp, "Ola Triangulo! -- Rossana\tFPS %.2lf", fps);
-				glfwSetWindowTitle(window, tmp);
+		double inicioFrame = glfwGetTime();
+		ContagemAlocacoes alocacoesAntes = contagemAlocacoes();
+		arenaFrame.reiniciar();
 
-				title_countdown_s = 0.1; // Reinicia o temporizador para atualizar o título periodicamente.
-			}
-		}
+		// Mostra o FPS na barra de título (Common/engine/Tempo.h)
+		if (!porEventos)
+			contadorFPS.atualizar(window, "Ola Triangulo! -- Rossana");
 
-		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
-		glfwPollEvents();
+		// Consome os eventos enfileirados pelo callback e avança a simulação
+		processarEntrada(window);
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -289,8 +494,10 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 		
-		currTime = glfwGetTime();
+		// Na reprodução o tempo da animação avança em passo fixo, igual em todas as execuções
+		currTime = sessao.reproduzindo() ? sessao.frameAtual() * sessao.passoFixo() : glfwGetTime();
 		deltaT = currTime - lastTime;
+		constantes.tempo = (float)currTime;
 
 		if (deltaT >= 1.0 / FPS)
 		{
@@ -298,369 +505,806 @@ int main()
 			lastTime = currTime;
 		}
 
-		desenharMapa(shaderID);
+		desenharCena(shaderID);
 		glfwSwapBuffers(window);
+		renderizadorGL.fimDoFrame();
+		cacheChunks.fimDoFrame();
+		agendador.agendar(lastTime + 1.0 / FPS);
+		agendador.desenhou();
+
+		fimDoFrameGL();
+		if (contarGL && INSTRUMENTACAO_GL) {
+			registrarContadoresGL();
+			if (glfwGetTime() >= proximoResumoGL) {
+				imprimirContadoresGL(cout);
+				proximoResumoGL = glfwGetTime() + 1.0;
+			}
+		}
+
+		relatorio.registrar(glfwGetTime() - inicioFrame);
+		registrarAlocacoesFrame(alocacoesAntes);
+		sessao.fimDoFrame();
 	}
-		
+
+	sessao.finalizar();
+	if (!opcoes.arquivoRelatorio.empty())
+		relatorio.salvarJson(opcoes.arquivoRelatorio, "Desafio");
+
+	if (cacheChunksPronto)
+		cacheChunks.relatorio(cout);
+	if (porEventos)
+		agendador.relatorio(cout);
+	cacheChunks.destruir();
+	folhaVampirao.liberar();
+
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
-	return 0;
+	return resultadoAlocacoes();
+}
+
+// Um Tile por ID do tileset, todos com o mesmo quad (VAO = 0 no modo --cpu). Com
+// texArray cada tile é uma camada; sem, uma fatia da faixa (o rasterizador de CPU)
+void criarTileset(GLuint texID, GLuint VAO, bool texArray)
+{
+	int fatias = texArray ? 1 : nTiles;
+	for (int i = 0; i < nTiles; i++){
+		Tile tile;
+		tile.dimensions = vec3(tileHeight, tileWidth,1.0);
+		tile.iTile = i;
+		tile.texID = texID;
+		tile.texArray = texArray;
+		tile.VAO = VAO;
+		tile.vertices = verticesTile(fatias);
+		tile.ds = 1.0f / fatias;
+		tile.dt = 1.0f;
+		tileset.push_back(tile);
+	}
+}
+
+// --cpu: o mesmo desenharMapa, sem janela e sem OpenGL. Com --reproduzir a sessão
+// inteira é simulada e desenhada; o último frame vai para o PNG.
+int executarCPU(const OpcoesSessao &opcoes, const string &arquivoMapa, const string &arquivoSaida)
+{
+	RasterizadorCPU cpu(WIDTH, HEIGHT);
+	renderizador = &cpu;
+
+	loadMapConfig(arquivoMapa);
+	GLuint texID = cpu.carregarTextura("../assets/tilesets/" + tilesetFile);
+	criarTileset(texID, 0, false);
+
+	vampirao.nAnimations = 4;
+	vampirao.nFrames = 6;
+	if (!texID || !folhaVampirao.recortar("../assets/sprites/Vampires1_Walk_full.png", vampirao.nAnimations, vampirao.nFrames))
+		return -1;
+	vampirao.VAO = 0;
+	vampirao.position = vec3(0.0, 0.0, 0.0);
+	vampirao.dimensions = vec3(tileWidth, tileHeight, 1.0);
+	vampirao.texID = cpu.adicionarTextura(folhaVampirao.atlasRGBA().data(), folhaVampirao.larguraAtlas(), folhaVampirao.alturaAtlas());
+	vampirao.iAnimation = 0;
+	vampirao.iFrame = 0;
+
+	double lastTime = 0.0;
+	double FPS = 12.0;
+	double totalMs = 0.0;
+	int frames = 0;
+	do
+	{
+		ContagemAlocacoes alocacoesAntes = contagemAlocacoes();
+		arenaFrame.reiniciar();
+		processarEntrada(nullptr);
+
+		double currTime = sessao.frameAtual() * sessao.passoFixo();
+		if (currTime - lastTime >= 1.0 / FPS)
+		{
+			vampirao.iFrame = (vampirao.iFrame + 1) % vampirao.nFrames;
+			lastTime = currTime;
+		}
+
+		auto inicio = chrono::steady_clock::now();
+		cpu.limpar(0.0f, 0.0f, 0.0f, 1.0f);
+		atualizarCamera();
+		desenharMapa();
+		cpu.finalizarFrame();
+		double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+		totalMs += segundos * 1000.0;
+		frames++;
+		relatorio.registrar(segundos);
+		registrarAlocacoesFrame(alocacoesAntes);
+		sessao.fimDoFrame();
+	} while (sessao.reproduzindo() && !sessao.terminou() && !fimDeJogo);
+
+	cout << "CPU: " << frames << " frame(s), " << totalMs / frames << " ms/frame" << endl;
+
+	sessao.finalizar();
+	if (!opcoes.arquivoRelatorio.empty())
+		relatorio.salvarJson(opcoes.arquivoRelatorio, "Desafio (CPU)");
+
+	if (!cpu.salvarPNG(arquivoSaida))
+		return -1;
+	return resultadoAlocacoes();
 }
 
 // Função de callback de teclado - só pode ter uma instância (deve ser estática se
 // estiver dentro de uma classe) - É chamada sempre que uma tecla for pressionada
-// ou solta via GLFW
+// ou solta via GLFW. Apenas enfileira o evento: toda a lógica roda em passoSimulacao
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
 {
-    if (action == GLFW_PRESS)
-    {
-        int targetX = playerX;
-        int targetY = playerY;
-
-        if (key == GLFW_KEY_W) {
-			targetX--;
-			vampirao.iAnimation = 2;
-		};
-        if (key == GLFW_KEY_S) {
-			targetX++;
-			vampirao.iAnimation = 1;
-		}
-        if (key == GLFW_KEY_A) {
-			targetY--;
-			vampirao.iAnimation = 3;
-		};
-        if (key == GLFW_KEY_D) {
-			targetY++;
-			vampirao.iAnimation = 0;
-		}
+	filaEntrada.push({glfwGetTime(), key, action, mode});
+	agendador.pedir();
+}
+
+// A roda do mouse controla o zoom; também passa pela fila para poder ser gravada
+void scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
+{
+	filaEntrada.push({glfwGetTime(), 0, 0, 0, EVENTO_SCROLL, xoffset, yoffset});
+	agendador.pedir();
+}
+
+// Cliques também passam pela fila, com a posição do cursor no momento do clique
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
+{
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+	filaEntrada.push({glfwGetTime(), button, action, mods, EVENTO_MOUSE, xpos, ypos});
+	agendador.pedir();
+}
 
-        // Diagonais
-        if (key == GLFW_KEY_Q) { 
-			targetX--; 
-			targetY--;
-			vampirao.iAnimation = 2; 
+// Traduz os eventos do frame (ao vivo ou reproduzidos do log) em ações através
+// da tabela de bindings
+void processarEntrada(GLFWwindow *window)
+{
+	sessao.consumir(filaEntrada, [window](const InputEvent &ev) {
+		if (ev.tipo == EVENTO_SCROLL) {
+			zoom = clamp(zoom * powf(1.1f, (float)ev.y), ZOOM_MIN, ZOOM_MAX);
+			return;
 		}
-        if (key == GLFW_KEY_E) { 
-			targetX--; 
-			targetY++;
-			vampirao.iAnimation = 2; 
+
+		if (ev.tipo == EVENTO_MOUSE) {
+			if (ev.key == GLFW_MOUSE_BUTTON_LEFT && ev.action == GLFW_PRESS)
+				cliqueNoMapa(window, ev.x, ev.y);
+			return;
 		}
-        if (key == GLFW_KEY_Z) { 
-			targetX++; 
-			targetY--;
-			vampirao.iAnimation = 1; 
+
+		if (ev.action != GLFW_PRESS)
+			return;
+
+		for (const BindingTecla &b : bindings)
+		{
+			if (b.key == ev.key)
+			{
+				passoSimulacao(window, b.acao);
+				break;
+			}
 		}
-        if (key == GLFW_KEY_C) { 
-			targetX++; 
-			targetY++;
-			vampirao.iAnimation = 1; 
+	});
+}
+
+// Clique em um tile vizinho move o jogador até ele; em qualquer outro tile mostra
+// o que há nele. O tile sai da inversa da projeção isométrica, sem percorrer o mapa.
+void cliqueNoMapa(GLFWwindow *window, double x, double y)
+{
+	float x0, y0;
+	origemMapa(x0, y0);
+
+	// Tela -> mundo: inversa da view montada em atualizarCamera (usa a câmera do
+	// último frame desenhado, que é o que estava na tela no momento do clique)
+	vec2 mundo = cameraCentro + (vec2((float)x, (float)y) - vec2(WIDTH / 2.0f, HEIGHT / 2.0f)) / zoom;
+
+	int i, j;
+	if (!pickIsometrico(mundo, vec2(x0, y0), vec2(tileset[0].dimensions.x, tileset[0].dimensions.y), mapHeight, mapWidth, i, j))
+		return;
+
+	int dX = i - playerX, dY = j - playerY;
+	if (abs(dX) <= 1 && abs(dY) <= 1 && (dX != 0 || dY != 0)) {
+		for (int acao = ACAO_NORTE; acao <= ACAO_SUDESTE; acao++) {
+			if (movimentos[acao].dX == dX && movimentos[acao].dY == dY) {
+				passoSimulacao(window, acao);
+				return;
+			}
 		}
+	}
 
-        if (targetX >= 0 && targetX < mapWidth && targetY >= 0 && targetY < mapHeight)
-        {
-			playerX = targetX;
-			playerY = targetY;
+	int tileID = tileMapa(i, j);
+	const TileProperties &props = tileProperties[tileID];
+	cout << "Tile [" << j << "," << i << "]: " << tileID
+		 << (props.isHazard ? " (perigo)" : "") << (props.isCollectible ? " (moeda)" : "")
+		 << (props.isChangeTile ? " (troca)" : "") << endl;
+}
 
-            int tileID = mapData[targetX][targetY];			
-			
-			// Se for hazard
-			if (tileProperties[tileID].isHazard) {
-				cout << "Você morreu ao pisar na tile " << tileID << "!" << endl;
+// Aplica uma ação do jogador: movimento, morte, coleta de moedas e troca de tile
+void passoSimulacao(GLFWwindow *window, int acao)
+{
+	if (acao == ACAO_NENHUMA)
+		return;
+
+	if (acao == ACAO_ALTERNAR_MODO_MAPA) {
+		do
+			modoMapa = (ModoMapa)((modoMapa + 1) % N_MODOS_MAPA);
+		while (!modoMapaDisponivel(modoMapa));
+		cout << "Modo de desenho do mapa: " << nomeModoMapa(modoMapa) << endl;
+		return;
+	}
+
+	if (acao == ACAO_ZOOM_MAIS || acao == ACAO_ZOOM_MENOS) {
+		zoom = clamp(zoom * (acao == ACAO_ZOOM_MAIS ? 1.25f : 0.8f), ZOOM_MIN, ZOOM_MAX);
+		return;
+	}
+
+	const AcaoMovimento &mov = movimentos[acao];
+	int targetX = playerX + mov.dX;
+	int targetY = playerY + mov.dY;
+	vampirao.iAnimation = mov.iAnimation;
+
+	// playerX é a linha (i) e playerY a coluna (j) da matriz do mapa
+	if (targetX >= 0 && targetX < mapHeight && targetY >= 0 && targetY < mapWidth)
+	{
+		playerX = targetX;
+		playerY = targetY;
+
+		int tileID = tileMapa(targetX, targetY);
+
+		// Se for hazard
+		if (tileProperties[tileID].isHazard) {
+			cout << "Você morreu ao pisar na tile " << tileID << "!" << endl;
+			fimDeJogo = true;
+			if (window)
 				glfwSetWindowShouldClose(window, GL_TRUE);
-			}
+		}
 
-			// Se for item coletável
-			if (tileProperties[tileID].isCollectible) {
-				cout << "Você coletou uma moeda na posição [" << playerY << "," << playerX << "]!" << endl;
-				mapData[playerX][playerY] = 0;
+		// Se for item coletável
+		if (tileProperties[tileID].isCollectible) {
+			cout << "Você coletou uma moeda na posição [" << playerY << "," << playerX << "]!" << endl;
+			tileMapa(playerX, playerY) = 0;
+			atualizarTileGPU(playerX, playerY);
 
-				moedasColetadas++;
+			moedasColetadas++;
 
-				if (moedasColetadas == totalMoedas) {
-					cout << "Parabéns! Você coletou todas as moedas e venceu o jogo!" << endl;
+			if (moedasColetadas == totalMoedas) {
+				cout << "Parabéns! Você coletou todas as moedas e venceu o jogo!" << endl;
+				fimDeJogo = true;
+				if (window)
 					glfwSetWindowShouldClose(window, GL_TRUE);
-				}
 			}
+		}
 
-			// se for para mudar de tile
-			if (tileProperties[tileID].isChangeTile) {
-				mapData[playerX][playerY] = 1;
-			}
+		// se for para mudar de tile
+		if (tileProperties[tileID].isChangeTile) {
+			tileMapa(playerX, playerY) = 1;
+			atualizarTileGPU(playerX, playerY);
+		}
+	}
+	else
+	{
+		cout << "Tentativa fora do mapa: [" << targetY << ", " << targetX << "]" << endl;
+	}
+}
 
-        }
-        else
-        {
-            cout << "Tentativa fora do mapa: [" << targetY << ", " << targetX << "]" << endl;
-        }
-    }
+// Canto de referência do tile [0][0] na tela, com a câmera parada e zoom 1
+void origemMapa(float &x0, float &y0)
+{
+	float tileW = tileset[0].dimensions.x;
+	float tileH = tileset[0].dimensions.y;
+
+	float mapPixelWidth = (mapWidth + mapHeight) * tileW / 8.0f;
+	float mapPixelHeight = (mapWidth + mapHeight) * tileH / 2.0f;
+
+	x0 = (WIDTH - mapPixelWidth) / 2.0f + tileW / 2.0f;
+	y0 = (HEIGHT - mapPixelHeight) / 2.0f + tileH / 4.0f;
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
+// Posiciona a câmera: projection e view vão para as constantes do frame (OpenGL) e
+// projection * view para o renderizador (o de CPU usa a matriz)
+void atualizarCamera()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
+	float tileW = tileset[0].dimensions.x;
+	float tileH = tileset[0].dimensions.y;
+	float x0, y0;
+	origemMapa(x0, y0);
+
+	// Extensão do losango completo do mapa em pixels (com zoom)
+	float larguraMapa = (mapWidth + mapHeight) * tileW / 2.0f * zoom;
+	float alturaMapa = (mapWidth + mapHeight) * tileH / 2.0f * zoom;
+
+	if (larguraMapa <= WIDTH && alturaMapa <= HEIGHT) {
+		cameraCentro = vec2(WIDTH / 2.0f, HEIGHT / 2.0f);
 	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
+	else {
+		// Segue o centro do tile do jogador
+		cameraCentro.x = x0 + (playerY - playerX) * tileW / 2.0f + tileW / 2.0f;
+		cameraCentro.y = y0 + (playerY + playerX) * tileH / 2.0f + tileH / 2.0f;
 	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
 
-	return shaderProgram;
+	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
+	mat4 view = mat4(1.0f);
+	view = translate(view, vec3(WIDTH / 2.0f, HEIGHT / 2.0f, 0.0f));
+	view = scale(view, vec3(zoom, zoom, 1.0f));
+	view = translate(view, vec3(-cameraCentro.x, -cameraCentro.y, 0.0f));
+	projecaoCamera = projection * view;
+	constantes.projection = projection;
+	constantes.view = view;
+	renderizador->projecao(projecaoCamera);
 }
 
-// Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
-// geometria de um triângulo
-// Apenas atributo coordenada nos vértices
-// 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
-// A função retorna o identificador do VAO
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+void desenharMapa()
 {
+	const Tile &baseTile = tileset[0];
+	float tileW = baseTile.dimensions.x;
+	float tileH = baseTile.dimensions.y;
 
-	ds = 1.0 / (float) nFrames;
-	dt = 1.0 / (float) nAnimations;
-	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
-	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
-	// Pode ser arazenado em um VBO único ou em VBOs separados
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		-0.5,  0.5, 0.0, 0.0, dt, //V0
-		-0.5, -0.5, 0.0, 0.0, 0.0, //V1
-		 0.5,  0.5, 0.0, ds, dt, //V2
-		 0.5, -0.5, 0.0, ds, 0.0  //V3
-		};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	float x0, y0;
+	origemMapa(x0, y0);
 
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
+	// Culling: retângulo do mundo visível na janela
+	float xMin = cameraCentro.x - WIDTH / 2.0f / zoom, xMax = cameraCentro.x + WIDTH / 2.0f / zoom;
+	float yMin = cameraCentro.y - HEIGHT / 2.0f / zoom, yMax = cameraCentro.y + HEIGHT / 2.0f / zoom;
 
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
+	// Só as linhas e colunas que cabem na janela (Common/CullingIso.h)
+	FaixaIso faixa = faixaVisivelIso(x0, y0, tileW, tileH, mapHeight, mapWidth, xMin, xMax, yMin, yMax);
 
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	// Os quads do frame vão para a arena e são enviados num lote só: nenhuma alocação
+	// no heap, e o RenderizadorGL não religa VAO e textura a cada tile
+	size_t total = 1;
+	for (int i = faixa.iMin; i <= faixa.iMax; i++)
+		total += std::max(0, faixa.jMax(i) - faixa.jMin(i) + 1);
+	QuadTexturizado *quads = arenaFrame.alocarArray<QuadTexturizado>(total);
+	size_t n = 0;
 
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
+	for (int i = faixa.iMin; i <= faixa.iMax; i++) {
+		int jMin = faixa.jMin(i), jMax = faixa.jMax(i);
+		for (int j = jMin; j <= jMax; j++) {
+			// Primeiro: Desenhar o tile de fundo normal
+			quads[n++] = quadTile(i, j, x0, y0);
 
-	return VAO;
+			// Segundo: Se for a posição do player, desenha o vampirão por cima
+			if (i == playerX && j == playerY) {
+				quads[n++] = quadJogador(x0 + (j - i) * tileW / 2.0f, y0 + (j + i) * tileH / 2.0f);
+			}
+		}
+	}
+	renderizador->desenharLote(quads, n);
 }
 
-int setupTile(int nTiles, float &ds, float &dt)
+// Quad do tile [i][j] do mapa, com o tile [0][0] em (x0, y0)
+QuadTexturizado quadTile(int i, int j, float x0, float y0)
 {
-    
-	ds = 1.0 / (float) nTiles;
-	dt = 1.0;
-	
-	// Como eu prefiro escalar depois, th e tw serão 1.0
-	float th = 1.0, tw = 1.0;
+	const Tile &curr_tile = tileset[tileMapa(i, j)];
+
+	float x = x0 + (j - i) * curr_tile.dimensions.x / 2.0f;
+	float y = y0 + (j + i) * curr_tile.dimensions.y / 2.0f;
+
+	QuadTexturizado quad;
+	quad.vao = curr_tile.VAO;
+	quad.vertices = curr_tile.vertices;
+	quad.textura = curr_tile.texID;
+	quad.model = translate(quad.model, vec3(x, y, 0.0f));
+	quad.model = scale(quad.model, curr_tile.dimensions);
+	if (curr_tile.texArray)
+		quad.camada = curr_tile.iTile;
+	else
+		quad.offsetTex = vec2(curr_tile.iTile * curr_tile.ds, 0.0f);
+	return quad;
+}
+
+// Desenha o vampirão sobre o tile cujo canto está em (x, y)
+void desenharJogador(float x, float y)
+{
+	renderizador->desenhar(quadJogador(x, y));
+}
+
+QuadTexturizado quadJogador(float x, float y)
+{
+	const Tile &baseTile = tileset[0];
+	float tileOffsetX = baseTile.dimensions.x * 0.5f;
+	float tileOffsetY = baseTile.dimensions.y * 0.25f;
+
+	float vampX = x + tileOffsetX;
+	float vampY = y + tileOffsetY;
+
+	// Cada frame tem o seu quad recortado no VAO da folha. A linha da imagem é a que
+	// o offset antigo (iAnimation * dt, com t invertido e a textura repetida) mostrava:
+	// a animação 0 é a última linha e as outras vêm a partir da primeira.
+	int linha = (vampirao.iAnimation + vampirao.nAnimations - 1) % vampirao.nAnimations;
+
+	QuadTexturizado quad;
+	quad.vao = vampirao.VAO;
+	quad.primeiroVertice = folhaVampirao.primeiroVertice(linha, vampirao.iFrame);
+	quad.vertices = folhaVampirao.verticesFrame(OrigemQuad::Centro, linha, vampirao.iFrame);
+	quad.textura = vampirao.texID;
+	quad.model = translate(quad.model, vec3(vampX, vampY, 0.0f));
+	quad.model = scale(quad.model, vec3(vampirao.dimensions.x, -vampirao.dimensions.y, 1.0f));
+	return quad;
+}
+
+// Desenha o frame no modo de mapa escolhido
+void desenharCena(GLuint shaderID)
+{
+	renderizadorGL.usarPrograma(shaderID);
+	atualizarCamera();
+	constantesFrame.atualizar(constantes);
+	if (modoMapa == MAPA_SHADER)
+		desenharMapaShader(shaderID);
+	else if (impostores.usar(zoom))
+		desenharMapaImpostores(shaderID);
+	else if (modoMapa == MAPA_INDIRETO)
+		desenharMapaIndireto(shaderID);
+	else if (modoMapa == MAPA_CACHE)
+		desenharMapaCache(shaderID);
+	else
+		desenharMapa();
+}
+
+bool modoMapaDisponivel(ModoMapa modo)
+{
+	if (modo == MAPA_SHADER)
+		return mapaTexID != 0;
+	if (modo == MAPA_INDIRETO)
+		return chunksMapaProntos;
+	if (modo == MAPA_CACHE)
+		return cacheChunksPronto;
+	return true;
+}
+
+const char *nomeModoMapa(ModoMapa modo)
+{
+	static const char *nomes[N_MODOS_MAPA] = {
+		"geometria (desenharMapa)", "shader (desenharMapaShader)", "indireto (desenharMapaIndireto)",
+		"cache (desenharMapaCache)"};
+	return nomes[modo];
+}
+
+// Cria a textura R16UI com os IDs do mapa e o quad que cobre o losango do mapa.
+// Retorna false (e o modo por shader fica indisponível) se o mapa não couber em
+// uma textura neste driver.
+bool setupMapaTextura()
+{
+	GLint maxTam = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTam);
+	if (mapWidth > maxTam || mapHeight > maxTam) {
+		cout << "Mapa " << mapWidth << "x" << mapHeight << " excede GL_MAX_TEXTURE_SIZE (" << maxTam
+			 << "): modo por shader desativado" << endl;
+		return false;
+	}
+
+	glGenTextures(1, &mapaTexID);
+	glBindTexture(GL_TEXTURE_2D, mapaTexID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// Linhas de mapWidth IDs de 16 bits: alinhamento de 2 bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, mapWidth, mapHeight, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, mapData.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
 
+	// Quad unitário (escalado para o retângulo do mapa pela matriz model)
 	GLfloat vertices[] = {
-		// x   y    z    s     t
-		0.0,  th/2.0f,   0.0, 0.0,    dt/2.0f, //A
-		tw/2.0f, th,     0.0, ds/2.0f, dt,     //B
-		tw/2.0f, 0.0,    0.0, ds/2.0f, 0.0,    //D
-		tw,     th/2.0f, 0.0, ds,     dt/2.0f  //C
-		};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
+		0.0, 0.0, 0.0,
+		0.0, 1.0, 0.0,
+		1.0, 0.0, 0.0,
+		1.0, 1.0, 0.0,
+	};
+
+	GLuint VBO;
 	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glGenVertexArrays(1, &mapaVAO);
+	glBindVertexArray(mapaVAO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
 	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
 	glBindVertexArray(0);
 
-	return VAO;
+	configurarShaderMapa();
+	return true;
 }
 
-int loadTexture(string filePath, int &width, int &height)
+// Unidades de textura do shader do mapa (de novo a cada recarga do programa)
+void configurarShaderMapa()
 {
-	GLuint texID;
+	glUseProgram(mapaShaderID);
+	glUniform1i(glGetUniformLocation(mapaShaderID, "camadas"), RenderizadorGL::UNIDADE_CAMADAS);
+	glUniform1i(glGetUniformLocation(mapaShaderID, "mapa"), 1);
+}
 
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
+// Uma troca de tile custa a escrita de um único texel no modo por shader e de um
+// ushort no buffer de instâncias do modo indireto; no modo por cache o chunk do tile
+// é redesenhado no próximo uso
+void atualizarTileGPU(int i, int j)
+{
+	if (chunksMapaProntos)
+		chunksMapa.atualizarTile(i, j, tileMapa(i, j));
+	impostores.atualizarTile(i, j);
+	if (cacheChunksPronto)
+		cacheChunks.invalidar((i / TAM_CHUNK_CACHE) * chunksCachePorLinha + j / TAM_CHUNK_CACHE);
+	if (!mapaTexID)
+		return;
+
+	glBindTexture(GL_TEXTURE_2D, mapaTexID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, j, i, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, &tileMapa(i, j));
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+// Desenha o mapa inteiro com um único quad e o jogador por cima
+void desenharMapaShader(GLuint shaderID)
+{
+	const Tile &baseTile = tileset[0];
+	float tileW = baseTile.dimensions.x;
+	float tileH = baseTile.dimensions.y;
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	float x0, y0;
+	origemMapa(x0, y0);
 
-	int nrChannels;
+	// Retângulo que contém o losango do mapa
+	float xMin = x0 - (mapHeight - 1) * tileW / 2.0f;
+	float xMax = x0 + (mapWidth - 1) * tileW / 2.0f + tileW;
+	float yMin = y0;
+	float yMax = y0 + (mapWidth + mapHeight - 2) * tileH / 2.0f + tileH;
 
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+	mat4 model = mat4(1.0f);
+	model = translate(model, vec3(xMin, yMin, 0.0f));
+	model = scale(model, vec3(xMax - xMin, yMax - yMin, 1.0f));
 
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
+	glUseProgram(mapaShaderID);
+	glUniformMatrix4fv(glGetUniformLocation(mapaShaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	glUniform2f(glGetUniformLocation(mapaShaderID, "origem"), x0, y0);
+	glUniform2f(glGetUniformLocation(mapaShaderID, "tamTile"), tileW, tileH);
 
-	stbi_image_free(data);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, mapaTexID);
+	glActiveTexture(GL_TEXTURE0 + RenderizadorGL::UNIDADE_CAMADAS);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, baseTile.texID);
+	glActiveTexture(GL_TEXTURE0);
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindVertexArray(mapaVAO);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-	return texID;
+	glUseProgram(shaderID);
+	desenharJogador(x0 + (playerY - playerX) * tileW / 2.0f, y0 + (playerY + playerX) * tileH / 2.0f);
 }
 
-void desenharMapa(GLuint shaderID)
+// Culling dos chunks e desenho do mapa inteiro na GPU, com o jogador por cima. A
+// janela é o mesmo retângulo que o desenharMapa usa para recortar na CPU.
+void desenharMapaIndireto(GLuint shaderID)
 {
-	Tile baseTile = tileset[0];
+	const Tile &baseTile = tileset[0];
 	float tileW = baseTile.dimensions.x;
 	float tileH = baseTile.dimensions.y;
 
-	float mapPixelWidth = (mapWidth + mapHeight) * tileW / 8.0f;
-	float mapPixelHeight = (mapWidth + mapHeight) * tileH / 2.0f;
+	float x0, y0;
+	origemMapa(x0, y0);
 
-	float x0 = (WIDTH - mapPixelWidth) / 2.0f + tileW / 2.0f;
-	float y0 = (HEIGHT - mapPixelHeight) / 2.0f + tileH / 4.0f;
+	vec4 janela(cameraCentro.x - WIDTH / 2.0f / zoom, cameraCentro.y - HEIGHT / 2.0f / zoom,
+				cameraCentro.x + WIDTH / 2.0f / zoom, cameraCentro.y + HEIGHT / 2.0f / zoom);
+	chunksMapa.desenhar(janela, baseTile.texID);
 
-	for (int i = 0; i < mapHeight; i++) {
-		for (int j = 0; j < mapWidth; j++) {
-			// Primeiro: Desenhar o tile de fundo normal
-			Tile curr_tile = tileset[mapData[i][j]];
+	glUseProgram(shaderID);
+	desenharJogador(x0 + (playerY - playerX) * tileW / 2.0f, y0 + (playerY + playerX) * tileH / 2.0f);
+}
 
-			float x = x0 + (j - i) * curr_tile.dimensions.x / 2.0f;
-			float y = y0 + (j + i) * curr_tile.dimensions.y / 2.0f;
+// Retângulo do mundo (xMin, yMin, xMax, yMax) que contém o losango do chunk [ci][cj]
+vec4 limitesChunkCache(int ci, int cj, float x0, float y0, float tileW, float tileH)
+{
+	int iMin = ci * TAM_CHUNK_CACHE, iMax = min(mapHeight, iMin + TAM_CHUNK_CACHE) - 1;
+	int jMin = cj * TAM_CHUNK_CACHE, jMax = min(mapWidth, jMin + TAM_CHUNK_CACHE) - 1;
+	return vec4(x0 + (jMin - iMax) * tileW / 2.0f, y0 + (jMin + iMin) * tileH / 2.0f,
+				x0 + (jMax - iMin) * tileW / 2.0f + tileW, y0 + (jMax + iMax) * tileH / 2.0f + tileH);
+}
 
-			mat4 model = mat4(1.0f);
-			model = translate(model, vec3(x, y, 0.0f));
-			model = scale(model, curr_tile.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+// Desenha os chunks visíveis a partir das texturas do cache, renderizando antes os que
+// faltam (novos, com tile trocado ou com outro zoom), e o jogador por cima. Os chunks
+// que não couberem no orçamento são desenhados tile a tile, na mesma ordem.
+void desenharMapaCache(GLuint shaderID)
+{
+	const Tile &baseTile = tileset[0];
+	float tileW = baseTile.dimensions.x;
+	float tileH = baseTile.dimensions.y;
 
-			vec2 offsetTex;
-			offsetTex.s = curr_tile.iTile * curr_tile.ds;
-			offsetTex.t = 0.0f;
-			glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
+	float x0, y0;
+	origemMapa(x0, y0);
 
-			glBindVertexArray(curr_tile.VAO);
-			glBindTexture(GL_TEXTURE_2D, curr_tile.texID);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	float xMin = cameraCentro.x - WIDTH / 2.0f / zoom, xMax = cameraCentro.x + WIDTH / 2.0f / zoom;
+	float yMin = cameraCentro.y - HEIGHT / 2.0f / zoom, yMax = cameraCentro.y + HEIGHT / 2.0f / zoom;
+	FaixaIso faixa = faixaVisivelIso(x0, y0, tileW, tileH, mapHeight, mapWidth, xMin, xMax, yMin, yMax);
+	if (faixa.iMin > faixa.iMax)
+		return;
 
-			// Segundo: Se for a posição do player, desenha o vampirão por cima
-			if (i == playerX && j == playerY) {
-				float tileOffsetX = baseTile.dimensions.x * 0.5f;
-				float tileOffsetY = baseTile.dimensions.y * 0.25f;
+	int jMinFaixa = mapWidth, jMaxFaixa = -1;
+	for (int i = faixa.iMin; i <= faixa.iMax; i++) {
+		jMinFaixa = min(jMinFaixa, faixa.jMin(i));
+		jMaxFaixa = max(jMaxFaixa, faixa.jMax(i));
+	}
+	int ciMin = faixa.iMin / TAM_CHUNK_CACHE, ciMax = faixa.iMax / TAM_CHUNK_CACHE;
+	int cjMin = max(0, jMinFaixa) / TAM_CHUNK_CACHE, cjMax = max(0, jMaxFaixa) / TAM_CHUNK_CACHE;
+
+	// Os tiles de um chunk, num lote (o renderizador copia os quads para o buffer de
+	// streaming, então o mesmo espaço da arena serve para todos os chunks)
+	QuadTexturizado *quadsChunk = arenaFrame.alocarArray<QuadTexturizado>((size_t)TAM_CHUNK_CACHE * TAM_CHUNK_CACHE);
+	auto desenharTilesChunk = [&](int ci, int cj) {
+		int iMax = min(mapHeight, (ci + 1) * TAM_CHUNK_CACHE), jMax = min(mapWidth, (cj + 1) * TAM_CHUNK_CACHE);
+		size_t n = 0;
+		for (int i = ci * TAM_CHUNK_CACHE; i < iMax; i++)
+			for (int j = cj * TAM_CHUNK_CACHE; j < jMax; j++)
+				quadsChunk[n++] = quadTile(i, j, x0, y0);
+		renderizador->desenharLote(quadsChunk, n);
+	};
+
+	// Primeiro passo: garante as texturas, com a projeção de cada chunk no bloco de
+	// constantes (view = identidade)
+	size_t maxChunks = (size_t)(ciMax - ciMin + 1) * (cjMax - cjMin + 1);
+	int *visiveis = arenaFrame.alocarArray<int>(maxChunks);
+	GLuint *texturas = arenaFrame.alocarArray<GLuint>(maxChunks);
+	size_t nVisiveis = 0;
+	bool desenhouNoCache = false;
+	for (int ci = ciMin; ci <= ciMax; ci++) {
+		for (int cj = cjMin; cj <= cjMax; cj++) {
+			vec4 l = limitesChunkCache(ci, cj, x0, y0, tileW, tileH);
+			if (l.x > xMax || l.z < xMin || l.y > yMax || l.w < yMin)
+				continue;
+
+			int chunk = ci * chunksCachePorLinha + cj;
+			GLuint tex = cacheChunks.textura(chunk, zoom);
+			mat4 projecaoChunk;
+			if (!tex && cacheChunks.comecar(chunk, l, zoom, projecaoChunk)) {
+				ConstantesFrame c = constantes;
+				c.projection = projecaoChunk;
+				c.view = mat4(1.0f);
+				constantesFrame.atualizar(c);
+				desenhouNoCache = true;
+
+				desenharTilesChunk(ci, cj);
+				tex = cacheChunks.terminar();
+			}
+			visiveis[nVisiveis] = chunk;
+			texturas[nVisiveis++] = tex;
+		}
+	}
+	if (desenhouNoCache)
+		constantesFrame.atualizar(constantes);
+
+	// Segundo passo: um quad por chunk (cor pré-multiplicada) e, para os recusados, os tiles
+	QuadTexturizado *compostos = arenaFrame.alocarArray<QuadTexturizado>(nVisiveis);
+	size_t n = 0;
+	auto comporPendentes = [&]() {
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		renderizador->desenharLote(compostos, n);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		n = 0;
+	};
+	for (size_t k = 0; k < nVisiveis; k++) {
+		if (texturas[k]) {
+			compostos[n++] = cacheChunks.quad(visiveis[k]);
+			continue;
+		}
+		comporPendentes();
+		desenharTilesChunk(visiveis[k] / chunksCachePorLinha, visiveis[k] % chunksCachePorLinha);
+	}
+	comporPendentes();
+
+	glUseProgram(shaderID);
+	desenharJogador(x0 + (playerY - playerX) * tileW / 2.0f, y0 + (playerY + playerX) * tileH / 2.0f);
+}
 
-				float vampX = x + tileOffsetX;
-				float vampY = y + tileOffsetY;
+// De longe: uma célula pré-renderizada por bloco de chunks visível, no nível de
+// detalhe do zoom, e o jogador por cima
+void desenharMapaImpostores(GLuint shaderID)
+{
+	const Tile &baseTile = tileset[0];
+	float tileW = baseTile.dimensions.x;
+	float tileH = baseTile.dimensions.y;
 
-				mat4 vampModel = mat4(1.0f);
-				vampModel = translate(vampModel, vec3(vampX, vampY, 0.0f));
-				vampModel = scale(vampModel, vec3(vampirao.dimensions.x, -vampirao.dimensions.y, 1.0f));
-				glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(vampModel));
+	float x0, y0;
+	origemMapa(x0, y0);
 
-				float offsetS = vampirao.iFrame * vampirao.ds;
-				float offsetT = vampirao.iAnimation * vampirao.dt;
-				glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetS, offsetT);
+	vec4 janela(cameraCentro.x - WIDTH / 2.0f / zoom, cameraCentro.y - HEIGHT / 2.0f / zoom,
+				cameraCentro.x + WIDTH / 2.0f / zoom, cameraCentro.y + HEIGHT / 2.0f / zoom);
+	impostores.desenhar(projecaoCamera, janela, zoom);
 
-				glBindVertexArray(vampirao.VAO);
-				glBindTexture(GL_TEXTURE_2D, vampirao.texID);
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			}
+	glUseProgram(shaderID);
+	desenharJogador(x0 + (playerY - playerX) * tileW / 2.0f, y0 + (playerY + playerX) * tileH / 2.0f);
+}
+
+// Compara os caminhos de desenho do mapa com a câmera atual: tempo de CPU para
+// submeter o frame e tempo de GPU medido com GL_TIME_ELAPSED
+void benchmarkMapa(GLFWwindow *window, GLuint shaderID, int nFrames)
+{
+	glfwSwapInterval(0);
+
+	GLuint query;
+	glGenQueries(1, &query);
+
+	ModoMapa modoOriginal = modoMapa;
+
+	cout << "Benchmark do mapa " << mapWidth << "x" << mapHeight << ", zoom " << zoom << ", " << nFrames << " frames por modo" << endl;
+	for (int modo = 0; modo < N_MODOS_MAPA; modo++) {
+		if (!modoMapaDisponivel((ModoMapa)modo))
+			continue;
+		modoMapa = (ModoMapa)modo;
+
+		double cpuTotal = 0.0, gpuTotal = 0.0;
+		double drawsTotal = 0.0, bindsTotal = 0.0;
+		for (int f = 0; f < nFrames; f++) {
+			arenaFrame.reiniciar();
+			double t0 = glfwGetTime();
+			glBeginQuery(GL_TIME_ELAPSED, query);
+
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glUseProgram(shaderID);
+			desenharCena(shaderID);
+
+			glEndQuery(GL_TIME_ELAPSED);
+			cpuTotal += glfwGetTime() - t0;
+			glfwSwapBuffers(window);
+			renderizadorGL.fimDoFrame();
+			cacheChunks.fimDoFrame();
+
+			GLuint64 ns = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+			gpuTotal += ns / 1.0e9;
+
+			fimDoFrameGL();
+			drawsTotal += contadoresGL().draws;
+			bindsTotal += contadoresGL().binds;
 		}
+
+		printf("  %-28s CPU %8.3f ms/frame   GPU %8.3f ms/frame\n", nomeModoMapa(modoMapa),
+			   cpuTotal * 1000.0 / nFrames, gpuTotal * 1000.0 / nFrames);
+		if (modoMapa != MAPA_SHADER && impostores.usar(zoom)) // zoom abaixo do --lod-zoom
+			printf("  %-28s impostores: nível %d, %d células/frame\n", "", impostores.nivelPara(zoom),
+				   impostores.celulasUltimoDesenho());
+		if (drawsTotal > 0) // só com --contar-gl e a engine instrumentada
+			printf("  %-28s %.0f draws/frame, %.0f binds/frame\n", "", drawsTotal / nFrames, bindsTotal / nFrames);
 	}
+
+	modoMapa = modoOriginal;
+	glDeleteQueries(1, &query);
+}
+
+// Médias por frame das chamadas OpenGL no --relatorio (com --contar-gl)
+void registrarContadoresGL()
+{
+	const ContadoresGL &c = contadoresGL();
+	relatorio.somarContador("gl_chamadas", c.chamadas);
+	relatorio.somarContador("gl_draws", c.draws);
+	relatorio.somarContador("gl_binds", c.binds);
+	relatorio.somarContador("gl_binds_redundantes", c.bindsRedundantes);
+	relatorio.somarContador("gl_uniforms", c.uniforms);
+	relatorio.somarContador("gl_estado", c.estado);
+	relatorio.somarContador("gl_uploads", c.uploads);
+	relatorio.somarContador("gl_bytes_enviados", (double)c.bytesEnviados);
+	relatorio.somarContador("gl_erros", c.erros);
+}
+
+// Alocações no heap do frame que começou em antes: vão para o --relatorio e, com
+// --checar-alocacoes, cada frame depois do aquecimento que alocou é reportado
+void registrarAlocacoesFrame(const ContagemAlocacoes &antes)
+{
+	ContagemAlocacoes agora = contagemAlocacoes();
+	uint64_t alocacoes = agora.alocacoes - antes.alocacoes;
+	relatorio.somarContador("alocacoes", (double)alocacoes);
+	relatorio.somarContador("bytes_alocados", (double)(agora.bytes - antes.bytes));
+
+	if (!checarAlocacoes || sessao.frameAtual() < FRAMES_AQUECIMENTO || alocacoes == 0)
+		return;
+	if (framesComAlocacao++ < 10)
+		cerr << "Frame " << sessao.frameAtual() << ": " << alocacoes << " alocação(ões), "
+			 << agora.bytes - antes.bytes << " bytes" << endl;
+}
+
+// Código de saída do programa com --checar-alocacoes (1 se algum frame alocou)
+int resultadoAlocacoes()
+{
+	if (!checarAlocacoes)
+		return 0;
+	if (framesComAlocacao > 0) {
+		cerr << "--checar-alocacoes: " << framesComAlocacao << " frame(s) alocaram no heap depois do aquecimento" << endl;
+		return 1;
+	}
+	cout << "--checar-alocacoes: nenhuma alocação no heap depois de " << FRAMES_AQUECIMENTO << " frames" << endl;
+	return 0;
 }
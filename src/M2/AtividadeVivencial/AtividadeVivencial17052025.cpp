@@ -25,62 +25,85 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// ProgramaShader e demais utilitários compartilhados (Common/engine)
+#include <Engine.h>
+
 using namespace glm;
 
 #include <cmath>
+#include <chrono>
+#include <cstdlib>
+
+// Seleção de triângulos pelo buffer de IDs
+#include <Picking.h>
+
+// VBO único compartilhado por todos os triângulos
+#include <PoolVertices.h>
+
+// Salvar/carregar a cena (binário mapeado em memória ou texto)
+#include <CenaFormas.h>
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
 // Protótipos das funções
-GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2);
-int setupShader();
+int createTriangle(float x0, float y0, float x1, float y1, float x2, float y2, vec3 cor);
 int setupGeometry();
+void salvarCenaAtual();
+void carregarCenaArquivo();
+int indiceTrianguloNoBloco(int bloco);
+void indexarTriangulos(int primeiro);
+int gerarCenaAleatoria(const string &arquivo, int n);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar *vertexShaderSource = R"(
-#version 400
-layout (location = 0) in vec3 position;
-uniform mat4 projection;
-uniform mat4 model;
-void main()	
-{
-	//...pode ter mais linhas de código aqui!
-	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
-}
-)";
-
-// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar *fragmentShaderSource = R"(
-#version 400
-uniform vec4 inputColor;
-out vec4 color;
-void main()
-{
-	color = inputColor;
-}
-)";
+// Shaders em arquivos (shaders/AtividadeVivencial17052025), recarregados quando são salvos
+const string DIR_SHADERS = "../shaders/AtividadeVivencial17052025/";
 
 struct Triangle 
 {
 	vec3 color;
-	GLuint vao;
+	int forma; // bloco do triângulo no pool
 };
 
+PoolVertices pool;
+
 vector<Triangle> triangles;
 
+// Índice em triangles de cada bloco de 3 vértices do pool (-1 = livre), para o
+// resultado do picking (o bloco) virar o triângulo sem percorrer a lista
+vector<int> trianguloNoBloco;
+
 vector <vec3> colors;
 int iColor = 0;
 
 vector <vec2> posicoesClicadas;
 
+// Botão direito seleciona o triângulo sob o cursor (DELETE remove o selecionado).
+// O clique só pede o picking; o passe de IDs roda no frame seguinte e o resultado
+// chega alguns frames depois, sem a CPU esperar pela GPU. Se nesse meio tempo a cena
+// mudou (DELETE, L), os índices do passe de IDs não valem mais e o resultado é descartado.
+PickingIdBuffer idBuffer;
+bool pedidoPicking = false;
+vec2 posicaoPicking;
+int iSelecionado = -1;
+unsigned geracaoCena = 0, geracaoPicking = 0;
+
+// S salva e L carrega a cena; extensão .pgsc = binário, qualquer outra = texto
+string arquivoCena = "cena.pgsc";
+
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
+	// --gerar-cena <arquivo> <n>: grava uma cena com n triângulos aleatórios e sai
+	if (argc >= 4 && string(argv[1]) == "--gerar-cena")
+		return gerarCenaAleatoria(argv[2], atoi(argv[3]));
+	bool carregarAoIniciar = argc >= 2;
+	if (carregarAoIniciar)
+		arquivoCena = argv[1];
+
 	// Inicialização da GLFW
 	glfwInit();
 
@@ -143,8 +166,18 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Compilando e buildando o programa de shader (ou lendo o binário do cache)
+	ProgramaShader shader;
+	if (!shader.carregar(DIR_SHADERS + "forma.vert", DIR_SHADERS + "forma.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shader.id();
+
+	idBuffer.init(width, height);
+	pool.init();
 
 	glUseProgram(shaderID);
 
@@ -152,18 +185,32 @@ int main()
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
 	// que não está nos buffers
 	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	GLint usarInputColorLoc = glGetUniformLocation(shaderID, "usarInputColor");
 
 	// Matriz de projeção paralela ortográfica
 	// mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
 	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
 
+	if (carregarAoIniciar)
+		carregarCenaArquivo();
+
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Shader editado em disco: o programa novo recebe a projeção de volta
+		if (shader.recarregarSeMudou())
+		{
+			shaderID = shader.id();
+			glUseProgram(shaderID);
+			colorLoc = glGetUniformLocation(shaderID, "inputColor");
+			usarInputColorLoc = glGetUniformLocation(shaderID, "usarInputColor");
+			glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+		}
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -171,20 +218,48 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
-		// glBindVertexArray(VAO); // Conectando ao buffer de geometria
+		// Matriz de modelo: os vértices já estão em coordenadas de tela
+		mat4 model = mat4(1); // matriz identidade
+		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+
+		// Todos os triângulos, com a cor de cada vértice, em uma chamada de desenho
+		glUniform1i(usarInputColorLoc, GL_FALSE);
+		pool.desenhar(GL_TRIANGLES);
 
-		for (int i = 0; i < triangles.size(); i++)
+		// Contorno branco no triângulo selecionado
+		if (iSelecionado >= 0)
 		{
-			glBindVertexArray(triangles[i].vao);
-			// Matriz de modelo: transformações na geometria (objeto)
+			glUniform1i(usarInputColorLoc, GL_TRUE);
+			glUniform4f(colorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+			glLineWidth(3);
+			glBindVertexArray(pool.vao());
+			glDrawArrays(GL_LINE_LOOP, pool.primeiro(triangles[iSelecionado].forma), 3);
+		}
 
-			mat4 model = mat4(1); // matriz identidade
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		// Passe de IDs: o pool inteiro numa chamada, cada triângulo com o seu bloco de
+		// 3 vértices no buffer + 1 (0 = fundo)
+		if (pedidoPicking)
+		{
+			idBuffer.begin(projection);
+			idBuffer.idPorVertice(3, mat4(1));
+			pool.desenhar(GL_TRIANGLES);
+
+			// Janela -> framebuffer (que pode ter outra escala) com origem embaixo
+			int winW, winH;
+			glfwGetWindowSize(window, &winW, &winH);
+			int px = (int)(posicaoPicking.x * width / winW);
+			int py = height - 1 - (int)(posicaoPicking.y * height / winH);
+			idBuffer.end(px, py);
+			pedidoPicking = false;
+			geracaoPicking = geracaoCena;
+		}
 
-			glUniform4f(colorLoc, triangles[i].color.r, triangles[i].color.g, triangles[i].color.b, 1.0f); // enviando cor para variável uniform inputColor
-			// Chamada de desenho - drawcall
-			// Poligono Preenchido - GL_TRIANGLES
-			glDrawArrays(GL_TRIANGLES, 0, 3);
+		uint32_t idPicking;
+		if (idBuffer.pendente() && idBuffer.resultado(idPicking) && geracaoPicking == geracaoCena)
+		{
+			iSelecionado = indiceTrianguloNoBloco((int)idPicking - 1);
+			if (iSelecionado >= 0)
+				cout << "Triângulo selecionado: " << iSelecionado << endl;
 		}
 		// Desenho com contorno (linhas)
 		// glUniform4f(colorLoc, 1.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
@@ -214,58 +289,116 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 {
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
+
+	if (key == GLFW_KEY_DELETE && action == GLFW_PRESS && iSelecionado >= 0 && iSelecionado < triangles.size())
+	{
+		trianguloNoBloco[pool.primeiro(triangles[iSelecionado].forma) / 3] = -1;
+		pool.liberar(triangles[iSelecionado].forma);
+		triangles.erase(triangles.begin() + iSelecionado);
+		indexarTriangulos(iSelecionado);
+		iSelecionado = -1;
+		geracaoCena++;
+	}
+
+	if (key == GLFW_KEY_S && action == GLFW_PRESS)
+		salvarCenaAtual();
+	if (key == GLFW_KEY_L && action == GLFW_PRESS)
+		carregarCenaArquivo();
+}
+
+// Triângulo cujos vértices começam em bloco * 3 no pool, ou -1 (fundo)
+int indiceTrianguloNoBloco(int bloco)
+{
+	return bloco >= 0 && bloco < (int)trianguloNoBloco.size() ? trianguloNoBloco[bloco] : -1;
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
+// Atualiza o índice dos triângulos a partir de primeiro (os que mudaram de posição
+// em triangles, depois de uma remoção, ou os novos)
+void indexarTriangulos(int primeiro)
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+	for (int i = primeiro; i < (int)triangles.size(); i++)
 	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
+		int bloco = pool.primeiro(triangles[i].forma) / 3;
+		if (bloco >= (int)trianguloNoBloco.size())
+			trianguloNoBloco.resize(bloco + 1, -1);
+		trianguloNoBloco[bloco] = i;
 	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
+}
+
+// Os vértices só existem no VBO do pool: lê o buffer de volta uma vez e grava os
+// triângulos na ordem de criação (posições já em coordenadas de tela)
+void salvarCenaAtual()
+{
+	vector<VerticeCor> buffer, vertices;
+	pool.copiarParaCPU(buffer);
+	vertices.reserve(triangles.size() * 3);
+	for (const Triangle &tri : triangles)
 	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
+		GLint primeiro = pool.primeiro(tri.forma);
+		vertices.insert(vertices.end(), buffer.begin() + primeiro, buffer.begin() + primeiro + 3);
 	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
+
+	if (salvarCena(arquivoCena, vertices, 3))
+		cout << "Cena salva em " << arquivoCena << " (" << triangles.size() << " triângulos)" << endl;
+}
+
+// Substitui a cena atual pela do arquivo. No binário, os vértices vão do arquivo
+// mapeado direto para o VBO em um único glBufferSubData.
+void carregarCenaArquivo()
+{
+	auto inicio = chrono::steady_clock::now();
+
+	CenaCarregada cena;
+	if (!carregarCena(arquivoCena, cena))
+		return;
+	if (cena.verticesPorForma != 3)
 	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
+		cout << "Erro: a cena não é de triângulos (" << cena.verticesPorForma << " vértices por forma)" << endl;
+		return;
 	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
 
-	return shaderProgram;
+	pool.limpar();
+	vector<int> ids;
+	pool.alocarLote(cena.vertices, cena.nFormas, 3, ids);
+
+	triangles.resize(cena.nFormas);
+	trianguloNoBloco.assign(pool.capacidadeVertices() / 3, -1);
+	for (int i = 0; i < cena.nFormas; i++)
+	{
+		const VerticeCor &v = cena.vertices[i * 3];
+		triangles[i].color = vec3(v.r, v.g, v.b);
+		triangles[i].forma = ids[i];
+	}
+	indexarTriangulos(0);
+	iSelecionado = -1;
+	geracaoCena++;
+	posicoesClicadas.clear();
+
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+	cout << "Cena carregada de " << arquivoCena << ": " << cena.nFormas << " triângulos em " << ms << " ms" << endl;
+}
+
+int gerarCenaAleatoria(const string &arquivo, int n)
+{
+	if (n <= 0)
+	{
+		cout << "Uso: --gerar-cena <arquivo> <numero de triangulos>" << endl;
+		return 1;
+	}
+
+	vector<VerticeCor> vertices((size_t)n * 3);
+	for (int i = 0; i < n; i++)
+	{
+		float cx = (float)(rand() % WIDTH), cy = (float)(rand() % HEIGHT);
+		float r = rand() / (float)RAND_MAX, g = rand() / (float)RAND_MAX, b = rand() / (float)RAND_MAX;
+		for (int k = 0; k < 3; k++)
+			vertices[i * 3 + k] = {cx + rand() % 21 - 10.0f, cy + rand() % 21 - 10.0f, 0.0f, r, g, b};
+	}
+
+	if (!salvarCena(arquivo, vertices, 3))
+		return 1;
+	cout << "Cena com " << n << " triângulos gravada em " << arquivo << endl;
+	return 0;
 }
 
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
@@ -320,53 +453,31 @@ int setupGeometry()
 	return VAO;
 }
 
-GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2)
+// Copia os vértices do triângulo (com a cor em cada vértice) para o pool compartilhado:
+// nenhum VBO/VAO novo é criado. Retorna o identificador do bloco no pool.
+int createTriangle(float x0, float y0, float x1, float y1, float x2, float y2, vec3 cor)
 {
-	GLuint VAO;
-
-	GLfloat vertices[] = {
-		// x    y    z
-		// T0
-		x0, y0, 0.0, // v0
-		x1, y1, 0.0, // v1
-		x2, y2, 0.0, // v2
+	VerticeCor vertices[] = {
+		// x   y   z    r      g      b
+		{x0, y0, 0.0, cor.r, cor.g, cor.b}, // v0
+		{x1, y1, 0.0, cor.r, cor.g, cor.b}, // v1
+		{x2, y2, 0.0, cor.r, cor.g, cor.b}, // v2
 	};
 
-	GLuint VBO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
+	return pool.alocar(vertices, 3);
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
+	if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS)
+	{
+		double xpos, ypos;
+		glfwGetCursorPos(window, &xpos, &ypos);
+		posicaoPicking = vec2(xpos, ypos);
+		pedidoPicking = true;
+		return;
+	}
+
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
     {
 		double xpos, ypos;
@@ -384,10 +495,11 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 			float x2 = posicoesClicadas[2].x;
 			float y2 = posicoesClicadas[2].y;
 
-			tri.vao = createTriangle(x0, y0, x1, y1, x2, y2);
 			tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
+			tri.forma = createTriangle(x0, y0, x1, y1, x2, y2, tri.color);
 			iColor = (iColor + 1) % colors.size();
 			triangles.push_back(tri);
+			indexarTriangulos((int)triangles.size() - 1);
 
 			posicoesClicadas.clear();
 		}
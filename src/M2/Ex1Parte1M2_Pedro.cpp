@@ -16,6 +16,9 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// ProgramaShader e demais utilitários compartilhados (Common/engine)
+#include <Engine.h>
+
 using namespace glm;
 
 #include <cmath>
@@ -24,33 +27,14 @@ using namespace glm;
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
 GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar *vertexShaderSource = R"(
- #version 400
- layout (location = 0) in vec3 position;
- void main()
- {
-	 gl_Position = vec4(position.x, position.y, position.z, 1.0);
- }
- )";
-
-// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar *fragmentShaderSource = R"(
- #version 400
- uniform vec4 inputColor;
- out vec4 color;
- void main()
- {
-	 color = inputColor;
- }
- )";
+// Shaders em arquivos (shaders/Ex1Parte1M2_Pedro), recarregados quando são salvos
+const string DIR_SHADERS = "../shaders/Ex1Parte1M2_Pedro/";
 
 // Função MAIN
 int main()
@@ -83,8 +67,15 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Compilando e buildando o programa de shader (ou lendo o binário do cache)
+	ProgramaShader shader;
+	if (!shader.carregar(DIR_SHADERS + "triangulo.vert", DIR_SHADERS + "triangulo.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shader.id();
 
 	vector<GLuint> VAOs;
 	VAOs.push_back(createTriangle(-0.65, 0.33, -0.27, 0.53, -0.61, 0.79));
@@ -125,6 +116,15 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Shader editado em disco: o programa novo recebe a cor de volta
+		if (shader.recarregarSeMudou())
+		{
+			shaderID = shader.id();
+			glUseProgram(shaderID);
+			colorLoc = glGetUniformLocation(shaderID, "inputColor");
+			glUniform4f(colorLoc, 0.0f, 0.0f, 1.0, 1.0f);
+		}
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -167,58 +167,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
@@ -16,54 +16,46 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// ProgramaShader e demais utilitários compartilhados (Common/engine)
+#include <Engine.h>
+
 using namespace glm;
 
 #include <cmath>
 
+// VBO único compartilhado por todos os triângulos
+#include <PoolVertices.h>
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
-GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2);
+struct Triangle;
+int adicionarTriangulo(const Triangle &tri);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar *vertexShaderSource = R"(
-#version 400
-layout (location = 0) in vec3 position;
-uniform mat4 projection;
-uniform mat4 model;
-void main()
-{
-	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
-}
-)";
-
-// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar *fragmentShaderSource = R"(
-#version 400
-uniform vec4 inputColor;
-out vec4 color;
-void main()
-{
-	color = inputColor;
-}
-)";
+// Shaders em arquivos (shaders/Ex1Parte2M2_Pedro), recarregados quando são salvos
+const string DIR_SHADERS = "../shaders/Ex1Parte2M2_Pedro/";
 
 struct Triangle
 {
 	vec3 position;
 	vec3 dimensions;
 	vec3 color;
+	int forma; // bloco do triângulo no pool
 };
 
 vector<Triangle> triangles;
 
+// Os triângulos já transformados (posição, rotação e escala) ficam todos em um só
+// VBO e são desenhados com uma chamada, em vez de uma matriz model e um drawcall
+// por triângulo
+PoolVertices pool;
+
 vector <vec3> colors;
 int iColor = 0;
 
@@ -118,16 +110,24 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Compilando e buildando o programa de shader (ou lendo o binário do cache)
+	ProgramaShader shader;
+	if (!shader.carregar(DIR_SHADERS + "triangulo.vert", DIR_SHADERS + "triangulo.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shader.id();
 
-	GLuint VAO = createTriangle(-0.5,-0.5,0.5,-0.5,0.0,0.5);
+	pool.init();
 
 	Triangle tri;
 	tri.position = vec3(400.0, 300.0, 0.0);
 	tri.dimensions = vec3(100.0, 100.0, 1.0);
 	tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
 	iColor = (iColor + 1) % colors.size();
+	tri.forma = adicionarTriangulo(tri);
 	triangles.push_back(tri);
 
 	glUseProgram(shaderID);
@@ -135,10 +135,7 @@ int main()
 	// Gerando um buffer simples, com a geometria de um triângulo
 	// GLuint VAO = setupGeometry();
 
-	// Enviando a cor desejada (vec4) para o fragment shader
-	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
-	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	// A cor agora vai em cada vértice (atributo location 1), junto com a posição
 
 	// Matriz de projeção paralela ortográfica
 	// mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
@@ -151,36 +148,26 @@ int main()
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Shader editado em disco: o programa novo recebe a projeção de volta
+		if (shader.recarregarSeMudou())
+		{
+			shaderID = shader.id();
+			glUseProgram(shaderID);
+			glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+		}
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		glLineWidth(10);
 		glPointSize(20);
-		glBindVertexArray(VAO);
-
-		for (int i = 0; i < triangles.size(); i++)
-		{
-			// Matriz de modelo: transformações na geometria (objeto)
-			mat4 model = mat4(1); // matriz identidade
-
-			// Translação
-			model = translate(model,vec3(triangles[i].position.x, triangles[i].position.y,0.0));
+		// Matriz de modelo: os vértices já foram transformados em adicionarTriangulo
+		mat4 model = mat4(1); // matriz identidade
+		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
 
-			model = rotate(model,radians(180.0f),vec3(0.0,0.0,1.0));
-
-			// Escala
-			model = scale(model,vec3(triangles[i].dimensions.x,triangles[i].dimensions.y,1.0));
-			
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			glUniform4f(colorLoc, triangles[i].color.r, triangles[i].color.g, triangles[i].color.b, 1.0f); // enviando cor para variável uniform inputColor
-
-			// Conectando ao buffer de geometria
-			// Chamada de desenho - drawcall
-			// Poligono Preenchido - GL_TRIANGLES
-			glDrawArrays(GL_TRIANGLES, 0, 3);
-		}
+		// Chamada de desenho - drawcall: todos os triângulos de uma vez
+		pool.desenhar(GL_TRIANGLES);
 
 		// glUniform4f(colorLoc, 0.0f, 0.0f, 1.0f, 1.0f); // enviando cor para variável uniform inputColor
 
@@ -209,58 +196,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
@@ -314,51 +249,6 @@ int setupGeometry()
 	return VAO;
 }
 
-GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2)
-{
-	GLuint VAO;
-
-	GLfloat vertices[] = {
-		// x    y    z
-		// T0
-		x0, y0, 0.0, // v0
-		x1, y1, 0.0, // v1
-		x2, y2, 0.0, // v2
-	};
-
-	GLuint VBO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
-}
-
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
@@ -372,6 +262,27 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 		tri.dimensions = vec3(100.0,100.0,1.0);
 		tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
 		iColor = (iColor + 1) % colors.size();
+		tri.forma = adicionarTriangulo(tri);
 		triangles.push_back(tri);
 	}
 }
+
+// Aplica a transformação do triângulo (a mesma matriz model que era enviada a cada
+// frame) uma única vez, na CPU, e copia os vértices resultantes para o pool
+int adicionarTriangulo(const Triangle &tri)
+{
+	const vec3 base[3] = {vec3(-0.5, -0.5, 0.0), vec3(0.5, -0.5, 0.0), vec3(0.0, 0.5, 0.0)};
+
+	mat4 model = mat4(1); // matriz identidade
+	model = translate(model, vec3(tri.position.x, tri.position.y, 0.0));
+	model = rotate(model, radians(180.0f), vec3(0.0, 0.0, 1.0));
+	model = scale(model, vec3(tri.dimensions.x, tri.dimensions.y, 1.0));
+
+	VerticeCor vertices[3];
+	for (int v = 0; v < 3; v++)
+	{
+		vec4 p = model * vec4(base[v], 1.0);
+		vertices[v] = {p.x, p.y, p.z, tri.color.r, tri.color.g, tri.color.b};
+	}
+	return pool.alocar(vertices, 3);
+}
@@ -25,50 +25,64 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// ProgramaShader e demais utilitários compartilhados (Common/engine)
+#include <Engine.h>
+
 using namespace glm;
 
 #include <cmath>
+#include <chrono>
 #include <ctime>
 
+// Fila de eventos de entrada, gravação/reprodução e relatório de frames
+#include <InputQueue.h>
+#include <InputLog.h>
+#include <FrameReport.h>
+
+// Desenho em lote de retângulos coloridos
+#include <ColorBatch.h>
+
+// Cores da grade em SoA + kernels SIMD de eliminação
+#include <GradeCores.h>
+
+// Célula sob o cursor
+#include <Picking.h>
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
+void processarEntrada(GLFWwindow *window);
 
 // Protótipos das funções
 GLuint createQuad();
-int setupShader();
 int setupGeometry();
 void eliminarSimilares(float tolerancia);
+void criarGrade();
+vec2 centroCelula(int k);
+void benchmarkEliminacao(int repeticoes);
+void desenharGradeIndividual(GLuint shaderID, GLint colorLoc, GLuint VAO);
+void desenharGradeLote(ColorBatch &batch, const mat4 &projection);
+void benchmarkGrade(GLFWwindow *window, GLuint shaderID, GLint colorLoc, GLuint VAO, ColorBatch &batch, const mat4 &projection, int nFrames);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
-const GLuint ROWS = 6, COLS = 8;
-const GLuint QUAD_WIDTH = 100, QUAD_HEIGHT = 100;
+
+// Dimensões da grade: 6x8 por padrão, configuráveis com --grade <linhas> <colunas>.
+// O tamanho de cada quad é calculado para a grade ocupar a janela inteira.
+int ROWS = 6, COLS = 8;
+float QUAD_WIDTH = 100, QUAD_HEIGHT = 100;
 const float dMax = sqrt(3.0);
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar *vertexShaderSource = R"(
-#version 400
-layout (location = 0) in vec3 position;
-uniform mat4 projection;
-uniform mat4 model;
-void main()	
-{
-	//...pode ter mais linhas de código aqui!
-	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
-}
-)";
-
-// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar *fragmentShaderSource = R"(
-#version 400
-uniform vec4 inputColor;
-out vec4 color;
-void main()
-{
-	color = inputColor;
-}
-)";
+// Métrica de semelhança, trocada com a tecla M: RGB normalizado por dMax (a
+// original), ΔE76 ou ΔE2000 (CIELAB). A tolerância de cada uma foi escolhida para
+// eliminar, em média, uma fração parecida da grade (~11%).
+MetricaCor metrica = METRICA_RGB;
+const float toleranciaMetrica[] = {0.2f, 35.0f, 18.0f};
+const char *nomeMetrica[] = {"RGB", "DeltaE76", "DeltaE2000"};
+
+// Shader da grade célula a célula (shaders/JogoDasCores_Pedro), usado pelo modo
+// quad a quad do --bench; o jogo desenha com o ColorBatch
+const string DIR_SHADERS = "../shaders/JogoDasCores_Pedro/";
 
 struct Quad
 {
@@ -80,19 +94,67 @@ struct Quad
 
 vector<Quad> triangles;
 
+size_t eliminarSimilaresReferencia(vector<Quad> &quads, vec3 C, float tolerancia);
+
 vector<vec3> colors;
 int iColor = 0;
 int iSelected = -1;
 int pontuacaoTotal = 0;
 int tentativas = 0;
 
-Quad grid[ROWS][COLS];
+// Cor e estado da célula da linha i, coluna j no índice i * COLS + j.
+// A posição e o tamanho de cada célula saem do índice (ver centroCelula).
+GradeCores cores;
+
+// A grade só é reenviada para o lote quando algum quad muda
+bool gradeAlterada = true;
+
+InputQueue<256> filaEntrada;
+SessaoEntrada sessao;
+FrameReport relatorio;
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	//srand(glfwGetTime()); TODO - Ver como transformar em unsigned int
-	srand(time(0));
+	// --gravar/--reproduzir/--relatorio/--headless/--semente (ver Common/InputLog.h)
+	OpcoesSessao opcoes = lerOpcoesSessao(argc, argv);
+	if (!sessao.iniciar(opcoes, 1.0f / 60.0f))
+		return -1;
+
+	// A semente vem da sessão: time(0) ao vivo, a semente gravada na reprodução
+	srand(sessao.sementeSessao());
+
+	// --grade <linhas> <colunas>: tamanho da grade (ex.: 1000 1000 para teste de carga)
+	// --bench <n>: mede n frames do desenho quad a quad e do desenho em lote e sai
+	// --bench-eliminar <n>: mede n eliminações com o laço original e com cada kernel e sai
+	// --sem-persistente: envia as instâncias mapeando o buffer a cada frame, mesmo com
+	// OpenGL 4.4 (para comparar com o mapeamento persistente)
+	int framesBenchmark = 0, repeticoesEliminacao = 0;
+	bool permitirPersistente = true;
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--grade" && i + 2 < argc)
+		{
+			ROWS = std::max(1, atoi(argv[++i]));
+			COLS = std::max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--bench" && i + 1 < argc)
+			framesBenchmark = atoi(argv[++i]);
+		else if (arg == "--bench-eliminar" && i + 1 < argc)
+			repeticoesEliminacao = atoi(argv[++i]);
+		else if (arg == "--sem-persistente")
+			permitirPersistente = false;
+	}
+	QUAD_WIDTH = (float)WIDTH / COLS;
+	QUAD_HEIGHT = (float)HEIGHT / ROWS;
+
+	// Não precisa de janela nem de contexto OpenGL
+	if (repeticoesEliminacao > 0)
+	{
+		benchmarkEliminacao(repeticoesEliminacao);
+		return 0;
+	}
 
 	// Inicialização da GLFW
 	glfwInit();
@@ -110,10 +172,17 @@ int main()
 	//	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 	// #endif
 
+	if (opcoes.headless)
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
 	// Criação da janela GLFW
 	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Jogo das cores! Pedro Teixeira Alves", nullptr, nullptr);
 	glfwMakeContextCurrent(window);
 
+	// Na reprodução o vsync limitaria a medição de tempo de frame
+	if (sessao.reproduzindo())
+		glfwSwapInterval(0);
+
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 	glfwSetMouseButtonCallback(window, mouse_button_callback);
@@ -135,28 +204,22 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Compilando e buildando o programa de shader (ou lendo o binário do cache)
+	ProgramaShader shader;
+	if (!shader.carregar(DIR_SHADERS + "grade.vert", DIR_SHADERS + "grade.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shader.id();
 
 	GLuint VAO = createQuad();
 
-  for (int i = 0; i < ROWS; i++)
-	{
-		for (int j = 0; j < COLS; j++)
-		{
-			Quad quad;
-			vec2 ini_pos = vec2(QUAD_WIDTH / 2, QUAD_HEIGHT / 2);
-			quad.position = vec3(ini_pos.x + j * QUAD_WIDTH, ini_pos.y + i * QUAD_HEIGHT, 0.0);
-			quad.dimensions = vec3(QUAD_WIDTH, QUAD_HEIGHT, 1.0);
-			float r, g, b;
-			r = rand() % 256 / 255.0;
-			g = rand() % 256 / 255.0;
-			b = rand() % 256 / 255.0;
-			quad.color = vec3(r, g, b);
-			quad.eliminated = false;
-			grid[i][j] = quad;
-		}
-	}
+	criarGrade();
+
+	ColorBatch batch;
+	batch.init(cores.size(), permitirPersistente);
 
 	// Triangle tri;
 	// tri.position = vec3(400.0,300.0,0.0);
@@ -177,11 +240,21 @@ int main()
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
 	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
 
+	if (framesBenchmark > 0)
+	{
+		benchmarkGrade(window, shaderID, colorLoc, VAO, batch, projection, framesBenchmark);
+		glfwTerminate();
+		return 0;
+	}
+
 	// Loop da aplicação - "game loop"
-	while (!glfwWindowShouldClose(window))
+	while (!glfwWindowShouldClose(window) && !sessao.terminou())
 	{
+		double inicioFrame = glfwGetTime();
+
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
+		processarEntrada(window);
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -190,40 +263,32 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
-		glBindVertexArray(VAO); // Conectando ao buffer de geometria
-
 		if (iSelected > -1)
 		{
-			eliminarSimilares(0.2);
-		}
-
-
-		for (int i = 0; i < ROWS; i++)
-		{
-			for (int j = 0; j < COLS; j++)
-			{
-				if (!grid[i][j].eliminated)
-				{
-					// Matriz de modelo: transformações na geometria (objeto)
-					mat4 model = mat4(1); // matriz identidade
-					// Translação
-					model = translate(model, grid[i][j].position);
-					//  Escala
-					model = scale(model, grid[i][j].dimensions);
-					glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-					glUniform4f(colorLoc, grid[i][j].color.r, grid[i][j].color.g, grid[i][j].color.b, 1.0f); // enviando cor para variável uniform inputColor
-					// Chamada de desenho - drawcall
-					// Poligono Preenchido - GL_TRIANGLES
-					glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
-				}
-			}
+			eliminarSimilares(toleranciaMetrica[metrica]);
 		}
 
-		glBindVertexArray(0); // Desconectando o buffer de geometria
+		// A grade inteira em uma chamada de desenho
+		desenharGradeLote(batch, projection);
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		batch.fimDoFrame();
+
+		const EstatisticasStreaming &streaming = batch.streaming().ultimoFrame();
+		relatorio.somarContador("streaming_bytes", (double)streaming.bytes);
+		relatorio.somarContador("streaming_esperas", streaming.esperas);
+		relatorio.somarContador("streaming_ms_esperando", streaming.segundosEsperando * 1000.0);
+
+		sessao.fimDoFrame();
+		relatorio.registrar(glfwGetTime() - inicioFrame);
 	}
+
+	batch.streaming().relatorio(cout);
+	sessao.finalizar();
+	if (!opcoes.arquivoRelatorio.empty())
+		relatorio.salvarJson(opcoes.arquivoRelatorio, "JogoDasCores");
+
 	// Pede pra OpenGL desalocar os buffers
 	// glDeleteVertexArrays(1, &VAO);
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
@@ -239,73 +304,41 @@ int main()
 // ou solta via GLFW
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
 {
-	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
-		glfwSetWindowShouldClose(window, GL_TRUE);
+	filaEntrada.push({glfwGetTime(), key, action, mode});
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no inicio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
+// Enfileira o clique junto com a posição do cursor, para que ele possa ser gravado
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+	filaEntrada.push({glfwGetTime(), button, action, mods, EVENTO_MOUSE, xpos, ypos});
 }
 
-void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
+// Aplica os eventos do frame (ao vivo ou reproduzidos do log)
+void processarEntrada(GLFWwindow *window)
 {
-	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
-	{
-		double xpos, ypos;
-		glfwGetCursorPos(window, &xpos, &ypos);
-		int x = xpos / QUAD_WIDTH;
-		int y = ypos / QUAD_HEIGHT;
-		grid[y][x].eliminated = true;
-		iSelected = x + y * COLS;
-	}
+	sessao.consumir(filaEntrada, [window](const InputEvent &ev) {
+		if (ev.tipo == EVENTO_TECLA && ev.key == GLFW_KEY_ESCAPE && ev.action == GLFW_PRESS)
+			glfwSetWindowShouldClose(window, GL_TRUE);
+
+		if (ev.tipo == EVENTO_TECLA && ev.key == GLFW_KEY_M && ev.action == GLFW_PRESS)
+		{
+			metrica = (MetricaCor)((metrica + 1) % 3);
+			cout << "Métrica de cor: " << nomeMetrica[metrica] << " (tolerância " << toleranciaMetrica[metrica] << ")" << endl;
+		}
+
+		if (ev.tipo == EVENTO_MOUSE && ev.key == GLFW_MOUSE_BUTTON_LEFT && ev.action == GLFW_PRESS)
+		{
+			// Cliques fora da grade (ou em células já eliminadas) são ignorados
+			int i, j;
+			if (!pickGrade(ev.x, ev.y, QUAD_WIDTH, QUAD_HEIGHT, ROWS, COLS, i, j) || cores.eliminado(i * COLS + j))
+				return;
+			cores.eliminar(i * COLS + j);
+			iSelected = i * COLS + j;
+			gradeAlterada = true;
+		}
+	});
 }
 
 GLuint createQuad()
@@ -358,29 +391,25 @@ void eliminarSimilares(float tolerancia)
 {
 	int x = iSelected % COLS;
 	int y = iSelected / COLS;
-	vec3 C = grid[y][x].color;
+	int k = y * COLS + x;
 
-	int eliminados = 0;
 	tentativas++; // Conta mais uma tentativa
 
-	for (int i = 0; i < ROWS; i++)
+	int eliminados;
+	if (metrica == METRICA_RGB)
 	{
-		for (int j = 0; j < COLS; j++)
-		{
-			if (!grid[i][j].eliminated)
-			{
-				vec3 O = grid[i][j].color;
-				float d = sqrt(pow(C.r - O.r, 2) + pow(C.g - O.g, 2) + pow(C.b - O.b, 2));
-				float dd = d / dMax;
-				if (dd <= tolerancia)
-				{
-					grid[i][j].eliminated = true;
-					eliminados++;
-				}
-			}
-		}
+		// d / dMax <= tolerancia  <=>  d² <= (tolerancia * dMax)²
+		float limiar = tolerancia * dMax;
+		eliminados = (int)cores.eliminarSimilares(cores.cor(k), limiar * limiar);
+	}
+	else
+	{
+		// Lab já convertido na criação da grade
+		eliminados = (int)cores.eliminarSimilares(cores.lab(k), tolerancia, metrica);
 	}
 
+	gradeAlterada = true;
+
 	if (eliminados > 0)
 	{
 		int pontos = (eliminados * 10) - (tentativas * 2);
@@ -397,3 +426,226 @@ void eliminarSimilares(float tolerancia)
 
 	iSelected = -1;
 }
+
+// Preenche a grade com cores aleatórias (usa o rand() semeado pela sessão)
+void criarGrade()
+{
+	cores.redimensionar((size_t)ROWS * COLS);
+	for (int k = 0; k < ROWS * COLS; k++)
+	{
+		float r, g, b;
+		r = rand() % 256 / 255.0;
+		g = rand() % 256 / 255.0;
+		b = rand() % 256 / 255.0;
+		cores.definir(k, vec3(r, g, b));
+	}
+	gradeAlterada = true;
+}
+
+vec2 centroCelula(int k)
+{
+	int i = k / COLS, j = k % COLS;
+	return vec2(QUAD_WIDTH / 2 + j * QUAD_WIDTH, QUAD_HEIGHT / 2 + i * QUAD_HEIGHT);
+}
+
+// Desenho original: um drawcall (e dois uniforms) por quad. Mantido para comparação
+void desenharGradeIndividual(GLuint shaderID, GLint colorLoc, GLuint VAO)
+{
+	glUseProgram(shaderID);
+	glBindVertexArray(VAO); // Conectando ao buffer de geometria
+
+	for (int k = 0; k < (int)cores.size(); k++)
+	{
+		if (!cores.eliminado(k))
+		{
+			vec3 cor = cores.cor(k);
+			// Matriz de modelo: transformações na geometria (objeto)
+			mat4 model = mat4(1); // matriz identidade
+			// Translação
+			model = translate(model, vec3(centroCelula(k), 0.0));
+			//  Escala
+			model = scale(model, vec3(QUAD_WIDTH, QUAD_HEIGHT, 1.0));
+			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+			glUniform4f(colorLoc, cor.r, cor.g, cor.b, 1.0f); // enviando cor para variável uniform inputColor
+			// Chamada de desenho - drawcall
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		}
+	}
+
+	glBindVertexArray(0); // Desconectando o buffer de geometria
+}
+
+// Desenho em lote: a grade só é reempacotada e reenviada quando muda
+void desenharGradeLote(ColorBatch &batch, const mat4 &projection)
+{
+	if (!gradeAlterada)
+	{
+		batch.redesenhar(projection);
+		return;
+	}
+
+	batch.begin();
+	vec2 tamanho(QUAD_WIDTH, QUAD_HEIGHT);
+	for (int k = 0; k < (int)cores.size(); k++)
+	{
+		if (!cores.eliminado(k))
+			batch.add(centroCelula(k), tamanho, cores.cor(k));
+	}
+	batch.flush(projection);
+	gradeAlterada = false;
+}
+
+// Compara o desenho quad a quad com o desenho em lote. No lote a grade é
+// reempacotada e reenviada em todo frame, o pior caso do streaming.
+void benchmarkGrade(GLFWwindow *window, GLuint shaderID, GLint colorLoc, GLuint VAO, ColorBatch &batch, const mat4 &projection, int nFrames)
+{
+	glfwSwapInterval(0);
+
+	GLuint query;
+	glGenQueries(1, &query);
+
+	const char *nomes[2] = {"quad a quad", "lote (instanciado)"};
+	cout << "Benchmark da grade " << ROWS << "x" << COLS << ", " << nFrames << " frames por modo" << endl;
+
+	for (int modo = 0; modo < 2; modo++)
+	{
+		double cpuTotal = 0.0, gpuTotal = 0.0;
+		for (int f = 0; f < nFrames; f++)
+		{
+			double t0 = glfwGetTime();
+			glBeginQuery(GL_TIME_ELAPSED, query);
+
+			glClear(GL_COLOR_BUFFER_BIT);
+			if (modo == 0)
+				desenharGradeIndividual(shaderID, colorLoc, VAO);
+			else
+			{
+				gradeAlterada = true;
+				desenharGradeLote(batch, projection);
+			}
+
+			glEndQuery(GL_TIME_ELAPSED);
+			cpuTotal += glfwGetTime() - t0;
+			glfwSwapBuffers(window);
+			batch.fimDoFrame();
+
+			GLuint64 ns = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+			gpuTotal += ns / 1.0e9;
+		}
+
+		printf("  %-20s CPU %8.3f ms/frame   GPU %8.3f ms/frame\n", nomes[modo],
+			   cpuTotal * 1000.0 / nFrames, gpuTotal * 1000.0 / nFrames);
+	}
+	batch.streaming().relatorio(cout);
+
+	glDeleteQueries(1, &query);
+}
+
+// Laço original de eliminarSimilares (AoS, sqrt/pow em double), mantido como referência
+size_t eliminarSimilaresReferencia(vector<Quad> &quads, vec3 C, float tolerancia)
+{
+	size_t eliminados = 0;
+	for (Quad &quad : quads)
+	{
+		if (!quad.eliminated)
+		{
+			vec3 O = quad.color;
+			float d = sqrt(pow(C.r - O.r, 2) + pow(C.g - O.g, 2) + pow(C.b - O.b, 2));
+			float dd = d / dMax;
+			if (dd <= tolerancia)
+			{
+				quad.eliminated = true;
+				eliminados++;
+			}
+		}
+	}
+	return eliminados;
+}
+
+// Compara o laço original com os kernels da GradeCores na grade de --grade
+// (ex.: --grade 2000 2000 --bench-eliminar 20). Cada repetição parte da grade cheia.
+// Roda antes do glfwInit, então o tempo vem do steady_clock (o glfwGetTime seria 0).
+void benchmarkEliminacao(int repeticoes)
+{
+	auto agora = []() { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+
+	srand(sessao.sementeSessao());
+	criarGrade();
+
+	vector<Quad> quads(cores.size());
+	for (size_t k = 0; k < quads.size(); k++)
+	{
+		quads[k].color = cores.cor(k);
+		quads[k].eliminated = false;
+	}
+
+	const float tolerancia = 0.2f;
+	const float limiar = tolerancia * dMax;
+	vector<vec3> alvos(repeticoes);
+	for (vec3 &alvo : alvos)
+		alvo = cores.cor(rand() % cores.size());
+
+	cout << "Eliminação em grade " << ROWS << "x" << COLS << " (" << cores.size() << " células), "
+		 << repeticoes << " repetições" << endl;
+
+	double tempoReferencia = 0.0;
+	size_t totalReferencia = 0;
+	for (const vec3 &alvo : alvos)
+	{
+		for (Quad &quad : quads)
+			quad.eliminated = false;
+		double t0 = agora();
+		totalReferencia += eliminarSimilaresReferencia(quads, alvo, tolerancia);
+		tempoReferencia += agora() - t0;
+	}
+	printf("  %-10s %9.3f ms/eliminação  (%zu eliminados)\n", "original", tempoReferencia * 1000.0 / repeticoes, totalReferencia);
+
+	for (int k = KERNEL_ESCALAR; k <= KERNEL_AVX2; k++)
+	{
+		KernelCores kernel = (KernelCores)k;
+		if (!cores.usarKernel(kernel))
+		{
+			printf("  %-10s não suportado nesta CPU\n", GradeCores::nomeKernel(kernel));
+			continue;
+		}
+
+		double tempo = 0.0;
+		size_t total = 0;
+		for (const vec3 &alvo : alvos)
+		{
+			cores.reviverTodas();
+			double t0 = agora();
+			total += cores.eliminarSimilares(alvo, limiar * limiar);
+			tempo += agora() - t0;
+		}
+		printf("  %-10s %9.3f ms/eliminação  (%zu eliminados, %.1fx)\n", GradeCores::nomeKernel(kernel),
+			   tempo * 1000.0 / repeticoes, total, tempoReferencia / tempo);
+	}
+
+	// Métricas perceptuais, com uma thread e com todas as threads da máquina
+	cores.usarKernel(GradeCores::melhorKernel());
+	unsigned nThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (int m = METRICA_DE76; m <= METRICA_DE2000; m++)
+	{
+		for (unsigned threads : {1u, nThreads})
+		{
+			cores.definirThreads(threads);
+			double tempo = 0.0;
+			size_t total = 0;
+			for (const vec3 &alvo : alvos)
+			{
+				CorLab lab = TabelaLab::instancia().converter(alvo);
+				cores.reviverTodas();
+				double t0 = agora();
+				total += cores.eliminarSimilares(lab, toleranciaMetrica[m], (MetricaCor)m);
+				tempo += agora() - t0;
+			}
+			printf("  %-10s %9.3f ms/eliminação  (%zu eliminados, %u threads)\n", nomeMetrica[m],
+				   tempo * 1000.0 / repeticoes, total, threads);
+			if (nThreads == 1)
+				break;
+		}
+	}
+	cores.definirThreads(0);
+}
@@ -1,116 +1,36 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
-const GLuint WIDTH = 800, HEIGHT = 800;
-
-// Vertex Shader
-const char* vertexShaderSource = R"(
-#version 400 core
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec2 texCoords;
-
-uniform mat4 model;
-uniform mat4 projection;
-uniform vec2 uvOffset;
-uniform vec2 uvScale;
-
-out vec2 TexCoords;
+// Fila de eventos de entrada, gravação/reprodução e relatório de frames
+#include <InputQueue.h>
+#include <InputLog.h>
+#include <FrameReport.h>
 
-void main()
-{
-    TexCoords = texCoords * uvScale + uvOffset;
-    gl_Position = projection * model * vec4(position, 1.0);
-}
-)";
+// ProgramaShader, loadTexture e SpriteSheet compartilhados (Common/engine)
+#include <Engine.h>
 
-// Fragment Shader
-const char* fragmentShaderSource = R"(
-#version 400 core
-in vec2 TexCoords;
-out vec4 color;
-
-uniform sampler2D image;
+const GLuint WIDTH = 800, HEIGHT = 800;
 
-void main()
-{
-    color = texture(image, TexCoords);
-}
-)";
+// Shaders em arquivos (shaders/RespostaControleAnimacoes), recarregados quando são salvos
+const std::string DIR_SHADERS = "../shaders/RespostaControleAnimacoes/";
 
 float playerX = 0.0f, playerY = 0.0f;
 const float moveSpeed = 0.01f;
 
-// Utilitário: Compilar shaders e linkar programa
-GLuint compileShaderProgram(const char* vSrc, const char* fSrc)
-{
-    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vSrc, nullptr);
-    glCompileShader(vertex);
-
-    GLint success;
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-        std::cerr << "Erro no Vertex Shader:\n" << infoLog << "\n";
-    }
-
-    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fSrc, nullptr);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-        std::cerr << "Erro no Fragment Shader:\n" << infoLog << "\n";
-    }
-
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
+// Estado das teclas montado a partir dos eventos consumidos no frame. Substitui o
+// polling com glfwGetKey para que uma sessão gravada possa ser reproduzida.
+bool teclasPressionadas[GLFW_KEY_LAST + 1] = {};
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-
-    return program;
-}
-
-// Carregamento de textura com STB
-GLuint loadTexture(const std::string& path)
-{
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, channels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
-
-    if (data) {
-        GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Wrapping & Filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    } else {
-        std::cerr << "Falha ao carregar textura: " << path << "\n";
-    }
-
-    stbi_image_free(data);
-    return textureID;
-}
+InputQueue<256> filaEntrada;
+SessaoEntrada sessao;
+FrameReport relatorio;
 
 struct Layer {
     GLuint texture;
@@ -118,10 +38,12 @@ struct Layer {
     glm::vec2 basePosition;
 };
 
-// Classe para desenhar sprites
+// Classe para desenhar sprites: os sprites do frame são enfileirados e saem pelo
+// RenderizadorGL, com a model e o deslocamento de textura de cada um no buffer de
+// streaming (nenhum uniform por sprite); a projeção vem do bloco ConstantesFrame
 class SpriteRenderer {
 public:
-    SpriteRenderer(GLuint shader) : shader(shader)
+    SpriteRenderer()
     {
         initRenderData();
     }
@@ -130,10 +52,46 @@ public:
         glDeleteVertexArrays(1, &quadVAO);
     }
 
-    void DrawSprite(GLuint texture, glm::vec2 position, glm::vec2 size, float rotate = 0.0f)
+    // Programa dos sprites; chamado de novo depois de recarregar os shaders
+    void SetShader(GLuint shader)
     {
         glUseProgram(shader);
+        glUniform1i(glGetUniformLocation(shader, "image"), 0);
+        renderizador.usarPrograma(shader);
+    }
+
+    void DrawSprite(GLuint texture, glm::vec2 position, glm::vec2 size, float rotate = 0.0f,
+                    glm::vec2 uvOffset = glm::vec2(0.0f))
+    {
+        lote.push_back(Prepare(quadVAO, 0, texture, position, size, rotate, uvOffset));
+    }
+
+    // Desenha só o quad recortado do frame, na posição dele dentro da célula position/size
+    void DrawFrame(SpriteSheet& folha, int linha, int coluna, glm::vec2 position, glm::vec2 size, float rotate = 0.0f)
+    {
+        lote.push_back(Prepare(folha.vao(OrigemQuad::CantoSuperiorEsquerdo), folha.primeiroVertice(linha, coluna),
+                               folha.textura(), position, size, rotate, glm::vec2(0.0f)));
+    }
+
+    // Desenha os sprites enfileirados, na ordem: os seguidos com o mesmo VAO e a
+    // mesma textura (os quatro blocos de uma camada) numa chamada instanciada
+    void Flush()
+    {
+        renderizador.desenharLote(lote.data(), lote.size());
+        lote.clear();
+    }
+
+    // Depois do glfwSwapBuffers
+    void EndFrame() { renderizador.fimDoFrame(); }
+
+private:
+    GLuint quadVAO;
+    RenderizadorGL renderizador;
+    std::vector<QuadTexturizado> lote;
 
+    QuadTexturizado Prepare(GLuint vao, GLint primeiroVertice, GLuint texture, glm::vec2 position,
+                            glm::vec2 size, float rotate, glm::vec2 uvOffset)
+    {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, glm::vec3(position, 0.0f));
         model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f));
@@ -141,20 +99,15 @@ public:
         model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f));
         model = glm::scale(model, glm::vec3(size, 1.0f));
 
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &model[0][0]);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glUniform1i(glGetUniformLocation(shader, "image"), 0);
-
-        glBindVertexArray(quadVAO);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
+        QuadTexturizado quad;
+        quad.vao = vao;
+        quad.primeiroVertice = primeiroVertice;
+        quad.textura = texture;
+        quad.model = model;
+        quad.offsetTex = uvOffset;
+        return quad;
     }
 
-private:
-    GLuint shader, quadVAO;
-
     void initRenderData()
     {
         float vertices[] = {
@@ -187,39 +140,37 @@ private:
 
 class CharacterController {
 public:
-    CharacterController(GLuint texture, GLuint shader, int nAnimations, int nFrames)
-        : texture(texture), shader(shader), nAnimations(nAnimations), nFrames(nFrames),
+    CharacterController(SpriteSheet& folha)
+        : folha(folha), nAnimations(folha.linhas()), nFrames(folha.colunas()),
           iAnimation(0), iFrame(0), frameTimer(0.0f), frameDuration(1.0f / 12.0f)
     {
-        ds = 1.0f / nFrames;
-		dt = 1.0f / nAnimations;
     }
 
-    void Update(float deltaTime, GLFWwindow* window) {
+    void Update(float deltaTime, const bool* teclas) {
 		frameTimer += deltaTime;
 		float actualSpeed = speed * deltaTime;
 
 		bool moved = false;
 
-		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
+		if (teclas[GLFW_KEY_W] || teclas[GLFW_KEY_UP]) {
 			position.y += actualSpeed;
 			playerY += actualSpeed; // Atualiza parallax
 			iAnimation = 1;
 			moved = true;
 		}
-		else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
+		else if (teclas[GLFW_KEY_S] || teclas[GLFW_KEY_DOWN]) {
 			position.y -= actualSpeed;
 			playerY -= actualSpeed;
 			iAnimation = 0;
 			moved = true;
 		}
-		else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+		else if (teclas[GLFW_KEY_A] || teclas[GLFW_KEY_LEFT]) {
 			position.x += actualSpeed;
 			playerX += actualSpeed;
 			iAnimation = 2;
 			moved = true;
 		}
-		else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+		else if (teclas[GLFW_KEY_D] || teclas[GLFW_KEY_RIGHT]) {
 			position.x -= actualSpeed;
 			playerX -= actualSpeed;
 			iAnimation = 3;
@@ -232,14 +183,9 @@ public:
 		}
 	}
 
+    // As coordenadas de textura do frame já estão no VAO da folha
     void Draw(SpriteRenderer& renderer) {
-        float offsetS = iFrame * ds;
-		float offsetT = iAnimation * dt;
-
-        glUseProgram(shader);
-		glUniform2f(glGetUniformLocation(shader, "uvOffset"), offsetS, offsetT);
-		glUniform2f(glGetUniformLocation(shader, "uvScale"), ds, dt);
-		renderer.DrawSprite(texture, position, size);
+		renderer.DrawFrame(folha, iAnimation, iFrame, position, size);
     }
 
     glm::vec2 position = glm::vec2(WIDTH / 2 - 200, HEIGHT / 2);
@@ -247,49 +193,85 @@ public:
     float speed = 2.0f;
 
 private:
-    GLuint texture, shader;
+    SpriteSheet& folha;
     int nAnimations, nFrames;
     int iAnimation, iFrame;
     float frameTimer, frameDuration;
-    float ds, dt;
 };
 
 const float minY = 0.0f;
 const float maxY = HEIGHT - 100.0f;
 
-void key_callback(GLFWwindow* window, int key, int, int action, int)
+// Só enfileira: o estado das teclas é atualizado em processarEntrada
+void key_callback(GLFWwindow* window, int key, int, int action, int mods)
+{
+    filaEntrada.push({glfwGetTime(), key, action, mods});
+}
+
+void processarEntrada(GLFWwindow* window)
 {
-    if ((action == GLFW_PRESS || action == GLFW_REPEAT) && key == GLFW_KEY_ESCAPE)
-        glfwSetWindowShouldClose(window, true);
+    sessao.consumir(filaEntrada, [window](const InputEvent& ev) {
+        if (ev.key < 0 || ev.key > GLFW_KEY_LAST)
+            return;
+
+        if (ev.action == GLFW_PRESS)
+            teclasPressionadas[ev.key] = true;
+        else if (ev.action == GLFW_RELEASE)
+            teclasPressionadas[ev.key] = false;
+
+        if ((ev.action == GLFW_PRESS || ev.action == GLFW_REPEAT) && ev.key == GLFW_KEY_ESCAPE)
+            glfwSetWindowShouldClose(window, true);
+    });
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --gravar/--reproduzir/--relatorio/--headless (ver Common/InputLog.h)
+    OpcoesSessao opcoes = lerOpcoesSessao(argc, argv);
+    if (!sessao.iniciar(opcoes, 1.0f / 60.0f))
+        return -1;
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (opcoes.headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
     GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Parallax Scene", nullptr, nullptr);
     glfwMakeContextCurrent(window);
+    if (sessao.reproduzindo())
+        glfwSwapInterval(0);
     glfwSetKeyCallback(window, key_callback);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    GLuint shader = compileShaderProgram(vertexShaderSource, fragmentShaderSource);
-    SpriteRenderer renderer(shader);
+    ProgramaShader programa;
+    if (!programa.carregar(DIR_SHADERS + "sprite.vert", DIR_SHADERS + "sprite.frag"))
+    {
+        std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    SpriteRenderer renderer;
+    renderer.SetShader(programa.id());
 
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WIDTH),
-                                      static_cast<float>(HEIGHT), 0.0f, -1.0f, 1.0f);
-    glUseProgram(shader);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, &projection[0][0]);
+    // A projeção não muda: vai para o bloco de constantes do frame, e não a cada sprite
+    BlocoConstantesFrame blocoConstantes;
+    blocoConstantes.init();
+    ConstantesFrame constantes;
+    constantes.projection = glm::ortho(0.0f, static_cast<float>(WIDTH),
+                                       static_cast<float>(HEIGHT), 0.0f, -1.0f, 1.0f);
+    constantes.viewport = glm::vec4(0.0f, 0.0f, WIDTH, HEIGHT);
 
-    // Personagem
-    GLuint playerTexture = loadTexture("../assets/sprites/Vampires1_Walk_full.png");
+    // Personagem: frames recortados pelo alfa e empacotados num atlas menor
+    SpriteSheet folhaPlayer;
+    folhaPlayer.importar("../assets/sprites/Vampires1_Walk_full.png", 4, 6);
+    folhaPlayer.relatorio(std::cout);
 
-	CharacterController player(playerTexture, shader, 4, 6);
+	CharacterController player(folhaPlayer);
 
     std::vector<Layer> layers = {
 		{ loadTexture("../assets/backgrounds/layers/1.png"), 0.1f, glm::vec2(0, 0) },
@@ -302,14 +284,45 @@ int main()
 
 	const float worldMoveSpeed = 0.3f;
 
-	while (!glfwWindowShouldClose(window))
+	// A simulação anda sempre em passos de sessao.passoFixo(), com a entrada consumida
+	// por passo: ao vivo o tempo real acumulado vira quantos passos couberem, na
+	// reprodução é um passo por frame. Assim a gravação e a reprodução fazem as mesmas
+	// contas, com os eventos nos mesmos passos.
+	const float passo = sessao.passoFixo();
+	const int MAX_PASSOS_POR_FRAME = 8; // depois de uma pausa longa, não tenta recuperar tudo
+	double tempoAcumulado = 0.0, lastTime = glfwGetTime();
+
+	while (!glfwWindowShouldClose(window) && !sessao.terminou())
 	{
+		double inicioFrame = glfwGetTime();
+
 		glfwPollEvents();
+
+		// Shader editado em disco: o programa novo recebe de volta as unidades de textura
+		if (programa.recarregarSeMudou())
+			renderer.SetShader(programa.id());
+
+		int passos = 1;
+		if (!sessao.reproduzindo())
+		{
+			tempoAcumulado += inicioFrame - lastTime;
+			lastTime = inicioFrame;
+			passos = std::min((int)(tempoAcumulado / passo), MAX_PASSOS_POR_FRAME);
+			tempoAcumulado = passos < MAX_PASSOS_POR_FRAME ? tempoAcumulado - passos * passo : 0.0;
+		}
+		for (int k = 0; k < passos; k++)
+		{
+			processarEntrada(window);
+			player.Update(passo, teclasPressionadas);
+			sessao.fimDoFrame();
+		}
+
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glUseProgram(shader);
-		
+		constantes.tempo = (float)glfwGetTime();
+		blocoConstantes.atualizar(constantes);
+
 		float backgroundMoveSpeed = 500.0f;
 
 		for (const Layer& layer : layers) {
@@ -322,37 +335,37 @@ int main()
 			glm::vec2 size = glm::vec2(WIDTH, HEIGHT);
 			glm::vec2 uvOffset = glm::vec2(offsetX / WIDTH, offsetY / HEIGHT);
 
-			glUniform2f(glGetUniformLocation(shader, "uvScale"), 1.0f, 1.0f);
-
 			// Bloco 1 (original)
-			glUniform2f(glGetUniformLocation(shader, "uvOffset"), uvOffset.x, uvOffset.y);
-			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX, -offsetY), size);
+			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX, -offsetY), size, 0.0f, uvOffset);
 
 			// Bloco 2 (direita)
-			glUniform2f(glGetUniformLocation(shader, "uvOffset"), uvOffset.x - 1.0f, uvOffset.y);
-			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX + WIDTH, -offsetY), size);
+			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX + WIDTH, -offsetY), size, 0.0f,
+			                    uvOffset - glm::vec2(1.0f, 0.0f));
 
 			// Bloco 3 (baixo)
-			glUniform2f(glGetUniformLocation(shader, "uvOffset"), uvOffset.x, uvOffset.y - 1.0f);
-			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX, -offsetY + HEIGHT), size);
+			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX, -offsetY + HEIGHT), size, 0.0f,
+			                    uvOffset - glm::vec2(0.0f, 1.0f));
 
 			// Bloco 4 (direita + baixo)
-			glUniform2f(glGetUniformLocation(shader, "uvOffset"), uvOffset.x - 1.0f, uvOffset.y - 1.0f);
-			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX + WIDTH, -offsetY + HEIGHT), size);
+			renderer.DrawSprite(layer.texture, glm::vec2(-offsetX + WIDTH, -offsetY + HEIGHT), size, 0.0f,
+			                    uvOffset - glm::vec2(1.0f, 1.0f));
 		}
 
 
-		float currentTime = glfwGetTime();
-		static float lastTime = currentTime;
-		float deltaTime = currentTime - lastTime;
-		lastTime = currentTime;
-
-		player.Update(deltaTime, window);
 		player.Draw(renderer);
+		renderer.Flush();
 
 		glfwSwapBuffers(window);
+		renderer.EndFrame();
+
+		relatorio.registrar(glfwGetTime() - inicioFrame);
 	}
 
+	sessao.finalizar();
+	if (!opcoes.arquivoRelatorio.empty())
+		relatorio.salvarJson(opcoes.arquivoRelatorio, "RespostaControleAnimacoes");
+
+    folhaPlayer.liberar();
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
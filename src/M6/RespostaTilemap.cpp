@@ -2,6 +2,7 @@
 #include <string>
 #include <assert.h>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 
@@ -11,15 +12,14 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 //GLM
 #include <glm/glm.hpp> 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// ProgramaShader, loadTexture, setupSprite/setupTile e o FPS na barra de título (Common/engine)
+#include <Engine.h>
+
 using namespace glm;
 
 struct Sprite {
@@ -43,41 +43,12 @@ struct Tile {
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
-int setupShader();
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
-int setupTile(int nTiles, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
-void desenharMapa(GLuint shaderID);
+void desenharMapa(RenderizadorGL &renderizador, vector<QuadTexturizado> &quads);
 
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-const GLchar *vertexShaderSource = R"(
- #version 400
- layout (location = 0) in vec3 position;
- layout (location = 1) in vec2 texc;
- out vec2 tex_coord;
- uniform mat4 model;
- uniform mat4 projection;
- void main()
- {
-	tex_coord = vec2(texc.s, 1.0 - texc.t);
-	gl_Position = projection * model * vec4(position, 1.0);
- }
- )";
-
-const GLchar *fragmentShaderSource = R"(
- #version 400
- in vec2 tex_coord;
- out vec4 color;
- uniform sampler2D tex_buff;
- uniform vec2 offsetTex;
-
- void main()
- {
-	 color = texture(tex_buff,tex_coord + offsetTex);
- }
- )";
-
+// Shaders em arquivos (shaders/RespostaTilemap), recarregados quando são salvos
+const string DIR_SHADERS = "../shaders/RespostaTilemap/";
 
 #define TILEMAP_WIDTH 5
 #define TILEMAP_HEIGHT 5
@@ -125,7 +96,15 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	GLuint shaderID = setupShader();
+	// Compilando e buildando o programa de shader (ou lendo o binário do cache)
+	ProgramaShader shader;
+	if (!shader.carregar(DIR_SHADERS + "tile.vert", DIR_SHADERS + "tile.frag"))
+	{
+		std::cerr << "Falha ao carregar os shaders de " << DIR_SHADERS << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	GLuint shaderID = shader.id();
 
 	// Carregando uma textura 
 	int imgWidth, imgHeight;
@@ -152,10 +131,15 @@ int main()
 		tileset.push_back(tile);
 	}
 
+	// Os tiles dividem o VAO e o tileset: o mapa inteiro sai numa chamada instanciada,
+	// com a model e o deslocamento de cada tile no buffer de streaming do renderizador
+	RenderizadorGL renderizador;
 	glUseProgram(shaderID);
+	renderizador.usarPrograma(shaderID);
+	vector<QuadTexturizado> quads;
+	quads.reserve(TILEMAP_WIDTH * TILEMAP_HEIGHT);
 
-	double prev_s = glfwGetTime();
-	double title_countdown_s = 0.1;
+	ContadorFPS contadorFPS;
 
 	float colorValue = 0.0;
 
@@ -163,8 +147,12 @@ int main()
 
 	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
 
-	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	// A projeção vai no bloco de constantes do frame (Common/engine/ConstantesFrame.h)
+	BlocoConstantesFrame blocoConstantes;
+	blocoConstantes.init();
+	ConstantesFrame constantes;
+	constantes.projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
+	constantes.viewport = vec4(0.0f, 0.0f, width, height);
 
 	glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
 	glDepthFunc(GL_ALWAYS); // Testa a cada ciclo
@@ -181,30 +169,24 @@ int main()
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
-		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
-		{
-			double curr_s = glfwGetTime();		// Obtém o tempo atual.
-			double elapsed_s = curr_s - prev_s; // Calcula o tempo decorrido desde o último frame.
-			prev_s = curr_s;					// Atualiza o "tempo anterior" para o próximo frame.
-
-			// Exibe o FPS, mas não a cada frame, para evitar oscilações excessivas.
-			title_countdown_s -= elapsed_s;
-			if (title_countdown_s <= 0.0 && elapsed_s > 0.0)
-			{
-				double fps = 1.0 / elapsed_s; // Calcula o FPS com base no tempo decorrido.
-
-				// Cria uma string e define o FPS como título da janela.
-				char tmp[256];
-				sprintf(tmp, "Ola Triangulo! -- Rossana\tFPS %.2lf", fps);
-				glfwSetWindowTitle(window, tmp);
-
-				title_countdown_s = 0.1; // Reinicia o temporizador para atualizar o título periodicamente.
-			}
-		}
+		// Mostra o FPS na barra de título (Common/engine/Tempo.h)
+		contadorFPS.atualizar(window, "Ola Triangulo! -- Rossana");
 
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
+		// Shader editado em disco: o programa novo recebe de volta as unidades de textura
+		if (shader.recarregarSeMudou())
+		{
+			shaderID = shader.id();
+			glUseProgram(shaderID);
+			glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+			renderizador.usarPrograma(shaderID);
+		}
+
+		constantes.tempo = (float)glfwGetTime();
+		blocoConstantes.atualizar(constantes);
+
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -212,7 +194,7 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
-		desenharMapa(shaderID);
+		desenharMapa(renderizador, quads);
 
 		//---------------------------------------------------------------------
 		// Desenho do vampirao
@@ -245,6 +227,7 @@ int main()
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		renderizador.fimDoFrame();
 	}
 		
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
@@ -274,257 +257,34 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
     }
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
-// Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
-// geometria de um triângulo
-// Apenas atributo coordenada nos vértices
-// 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
-// A função retorna o identificador do VAO
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
-{
-
-	ds = 1.0 / (float) nFrames;
-	dt = 1.0 / (float) nAnimations;
-	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
-	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
-	// Pode ser arazenado em um VBO único ou em VBOs separados
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		-0.5,  0.5, 0.0, 0.0, dt, //V0
-		-0.5, -0.5, 0.0, 0.0, 0.0, //V1
-		 0.5,  0.5, 0.0, ds, dt, //V2
-		 0.5, -0.5, 0.0, ds, 0.0  //V3
-		};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
-}
-
-int setupTile(int nTiles, float &ds, float &dt)
-{
-    
-	ds = 1.0 / (float) nTiles;
-	dt = 1.0;
-	
-	// Como eu prefiro escalar depois, th e tw serão 1.0
-	float th = 1.0, tw = 1.0;
-
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		0.0,  th/2.0f,   0.0, 0.0,    dt/2.0f, //A
-		tw/2.0f, th,     0.0, ds/2.0f, dt,     //B
-		tw/2.0f, 0.0,    0.0, ds/2.0f, 0.0,    //D
-		tw,     th/2.0f, 0.0, ds,     dt/2.0f  //C
-		};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
-}
-
-int loadTexture(string filePath, int &width, int &height)
-{
-	GLuint texID;
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
-}
-
-void desenharMapa(GLuint shaderID)
+void desenharMapa(RenderizadorGL &renderizador, vector<QuadTexturizado> &quads)
 {
 	//dá pra fazer um cálculo usando tilemap_width e tilemap_height
 	float x0 = 400;
 	float y0 = 100;
 
+	quads.clear();
 	for(int i = 0; i<TILEMAP_HEIGHT; i++)
 	{
 		for (int j=0; j < TILEMAP_WIDTH; j++)
 		{
-			// Matriz de transformaçao do objeto - Matriz de modelo
-			mat4 model = mat4(1); //matriz identidade
-			
-			Tile curr_tile;
-
-			if (i == playerY && j == playerX)
-			{
-				curr_tile = tileset[0];  // Tile 0 representa o jogador
-			}
-			else
-			{
-				curr_tile = tileset[map[i][j]];
-			}
+			// Referência para o tile do tileset, sem copiar o Tile a cada célula.
+			// Tile 0 representa o jogador.
+			const Tile &curr_tile = (i == playerY && j == playerX) ? tileset[0] : tileset[map[i][j]];
 
 			float x = x0 + (j-i) * curr_tile.dimensions.x/2.0;
 			float y = y0 + (j+i) * curr_tile.dimensions.y/2.0;
 
-			model = translate(model, vec3(x,y,0.0));
-			model = scale(model,curr_tile.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			vec2 offsetTex;
-
-			offsetTex.s = curr_tile.iTile * curr_tile.ds;
-			offsetTex.t = 0.0;
-			glUniform2f(glGetUniformLocation(shaderID, "offsetTex"),offsetTex.s, offsetTex.t);
-
-			glBindVertexArray(curr_tile.VAO); // Conectando ao buffer de geometria
-			glBindTexture(GL_TEXTURE_2D, curr_tile.texID); // Conectando ao buffer de textura
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4); 
+			QuadTexturizado quad;
+			quad.vao = curr_tile.VAO; // buffer de geometria
+			quad.textura = curr_tile.texID; // buffer de textura
+			// Matriz de transformaçao do objeto - Matriz de modelo
+			quad.model = scale(translate(mat4(1), vec3(x,y,0.0)), curr_tile.dimensions);
+			quad.offsetTex = vec2(curr_tile.iTile * curr_tile.ds, 0.0);
+			quads.push_back(quad);
 		}
 	}
+
+	// Uma chamada para o mapa todo, sem uniforms por tile
+	renderizador.desenharLote(quads.data(), quads.size());
 }